@@ -0,0 +1,373 @@
+/* Corpus driven benchmark of all scorers
+ *
+ * Every line of a corpus file is used as one string. The strings are grouped into length buckets and
+ * each scorer is run in its plain, Cached and Multi form for a sweep of score_cutoff values.
+ *
+ * usage:
+ *   bench_corpus [--corpus=<name>:<path>]... [--corpus_queries=<n>] [--corpus_choices=<n>] [benchmark flags]
+ *
+ * Without --corpus the OCR example of the tests is sliced into strings of every length bucket.
+ * Use --benchmark_out=<file>.json --benchmark_out_format=json to store results, which can be compared
+ * across releases with tools/compare.py of google benchmark. --benchmark_filter=<regex> restricts the sweep
+ * to some scorers, variants, corpora, length buckets or cutoffs, e.g. --benchmark_filter=Levenshtein/Multi.
+ */
+#include <benchmark/benchmark.h>
+#include <rapidfuzz/distance.hpp>
+#include <rapidfuzz/fuzz.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "examples/ocr.hpp"
+
+namespace rf = rapidfuzz;
+
+struct LengthBucket {
+    size_t min_len;
+    size_t max_len;
+};
+
+static const LengthBucket length_buckets[] = {{1, 8},   {9, 16},   {17, 32},  {33, 64},
+                                              {65, 128}, {129, 512}, {513, 2048}};
+
+static const double score_cutoffs[] = {0.0, 0.5, 0.8, 0.95};
+
+struct Corpus {
+    std::string name;
+    std::vector<std::string> lines;
+};
+
+struct Workload {
+    std::string corpus;
+    LengthBucket bucket;
+    std::vector<std::string> queries;
+    std::vector<std::string> choices;
+};
+
+static size_t query_count = 16;
+static size_t choice_count = 256;
+
+static std::string bucket_name(const LengthBucket& bucket)
+{
+    return "len:" + std::to_string(bucket.min_len) + "-" + std::to_string(bucket.max_len);
+}
+
+static std::string cutoff_name(double cutoff)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "cutoff:%.2f", cutoff);
+    return buf;
+}
+
+static bool load_corpus(const std::string& arg, Corpus& corpus)
+{
+    size_t sep = arg.find(':');
+    corpus.name = arg.substr(0, sep);
+    std::ifstream file((sep == std::string::npos) ? arg : arg.substr(sep + 1));
+    if (!file) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) corpus.lines.push_back(std::move(line));
+    }
+    return true;
+}
+
+/* slices of both OCR scans of the same document, so choices share a lot of content */
+static Corpus ocr_corpus()
+{
+    Corpus corpus{"ocr", {}};
+    std::mt19937 gen(42);
+    const std::basic_string<uint8_t>* examples[] = {&ocr_example1, &ocr_example2};
+
+    for (const auto& bucket : length_buckets) {
+        for (const auto* example : examples) {
+            size_t max_len = std::min(bucket.max_len, example->size());
+            if (max_len < bucket.min_len) continue;
+
+            std::uniform_int_distribution<size_t> len_dist(bucket.min_len, max_len);
+            for (size_t i = 0; i < choice_count; ++i) {
+                size_t len = len_dist(gen);
+                std::uniform_int_distribution<size_t> pos_dist(0, example->size() - len);
+                size_t pos = pos_dist(gen);
+                corpus.lines.emplace_back(example->begin() + static_cast<ptrdiff_t>(pos),
+                                          example->begin() + static_cast<ptrdiff_t>(pos + len));
+            }
+        }
+    }
+    return corpus;
+}
+
+static std::vector<Workload> make_workloads(const Corpus& corpus)
+{
+    std::vector<Workload> workloads;
+    std::mt19937 gen(42);
+
+    for (const auto& bucket : length_buckets) {
+        std::vector<std::string> strings;
+        for (const auto& line : corpus.lines)
+            if (line.size() >= bucket.min_len && line.size() <= bucket.max_len) strings.push_back(line);
+
+        if (strings.size() < 2) continue;
+        std::shuffle(strings.begin(), strings.end(), gen);
+
+        Workload workload{corpus.name, bucket, {}, {}};
+        /* fewer choices for long strings, so the benchmarks of all buckets finish in a similar time */
+        size_t bucket_choices = std::max<size_t>(1, choice_count * 64 / std::max<size_t>(bucket.max_len, 64));
+        size_t queries = std::min(query_count, strings.size() / 2);
+        size_t choices = std::min(bucket_choices, strings.size() - queries);
+        workload.queries.assign(strings.begin(), strings.begin() + static_cast<ptrdiff_t>(queries));
+        workload.choices.assign(strings.begin() + static_cast<ptrdiff_t>(queries),
+                                strings.begin() + static_cast<ptrdiff_t>(queries + choices));
+        workloads.push_back(std::move(workload));
+    }
+    return workloads;
+}
+
+static void set_rate(benchmark::State& state, const Workload& workload)
+{
+    auto pairs = static_cast<int64_t>(workload.queries.size() * workload.choices.size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * pairs);
+    state.counters["Rate"] = benchmark::Counter(static_cast<double>(state.iterations() * pairs),
+                                                benchmark::Counter::kIsRate);
+    state.counters["InvRate"] = benchmark::Counter(static_cast<double>(state.iterations() * pairs),
+                                                   benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <typename Func>
+static void register_benchmark(const std::string& scorer, const std::string& variant,
+                               const Workload& workload, double cutoff, Func func)
+{
+    std::string name = scorer + "/" + variant + "/" + workload.corpus + "/" + bucket_name(workload.bucket) +
+                       "/" + cutoff_name(cutoff);
+    benchmark::RegisterBenchmark(name.c_str(), [workload, cutoff, func](benchmark::State& state) {
+        func(state, workload, cutoff);
+        set_rate(state, workload);
+    });
+}
+
+/* free function comparing every query with every choice */
+template <typename Scorer>
+static void register_plain(const std::string& name, const Workload& workload, double cutoff, Scorer scorer)
+{
+    register_benchmark(name, "Plain", workload, cutoff,
+                       [scorer](benchmark::State& state, const Workload& w, double score_cutoff) {
+                           for (auto _ : state)
+                               for (const auto& query : w.queries)
+                                   for (const auto& choice : w.choices)
+                                       benchmark::DoNotOptimize(scorer(query, choice, score_cutoff));
+                       });
+}
+
+/* cached scorer created once per query, which includes the preprocessing of the query */
+template <typename MakeCached, typename Scorer>
+static void register_cached(const std::string& name, const Workload& workload, double cutoff,
+                            MakeCached make_cached, Scorer scorer)
+{
+    register_benchmark(name, "Cached", workload, cutoff,
+                       [make_cached, scorer](benchmark::State& state, const Workload& w, double c) {
+                           for (auto _ : state) {
+                               for (const auto& query : w.queries) {
+                                   auto cached = make_cached(query);
+                                   for (const auto& choice : w.choices)
+                                       benchmark::DoNotOptimize(scorer(cached, choice, c));
+                               }
+                           }
+                       });
+}
+
+#ifdef RAPIDFUZZ_SIMD
+/* multi scorer created once for all choices outside of the timed loop */
+template <typename MakeMulti, typename Scorer>
+static void register_multi(const std::string& name, const Workload& workload, double cutoff,
+                           MakeMulti make_multi, Scorer scorer)
+{
+    register_benchmark(name, "Multi", workload, cutoff,
+                       [make_multi, scorer](benchmark::State& state, const Workload& w, double score_cutoff) {
+                           auto multi = make_multi(w.choices);
+                           std::vector<double> results(multi.result_count());
+                           for (auto _ : state) {
+                               for (const auto& query : w.queries) {
+                                   scorer(multi, results.data(), results.size(), query, score_cutoff);
+                                   benchmark::DoNotOptimize(results.data());
+                               }
+                           }
+                       });
+}
+
+static const auto multi_normalized_similarity = [](const auto& multi, double* scores, size_t count,
+                                                    const std::string& s2, double c) {
+    multi.normalized_similarity(scores, count, s2, c);
+};
+
+static const auto multi_fuzz_similarity = [](const auto& multi, double* scores, size_t count,
+                                              const std::string& s2, double c) {
+    multi.similarity(scores, count, s2, c * 100);
+};
+
+/* simd scorers without a MultiScorer front end, which only support strings up to 64 characters */
+template <template <int> class MultiT, typename Scorer>
+static void register_simd_multi(const std::string& name, const Workload& workload, double cutoff,
+                                Scorer scorer)
+{
+    auto make_multi = [](const std::vector<std::string>& choices) {
+        MultiT<64> multi(choices.size());
+        for (const auto& choice : choices)
+            multi.insert(choice);
+        return multi;
+    };
+
+    if (workload.bucket.max_len <= 64) register_multi(name, workload, cutoff, make_multi, scorer);
+}
+#endif
+
+/* scorers with arguments between s2 and score_cutoff, which are benchmarked with the default arguments */
+static double levenshtein_normalized_similarity(const std::string& s1, const std::string& s2, double cutoff)
+{
+    return rf::levenshtein_normalized_similarity(s1, s2, {1, 1, 1}, cutoff);
+}
+
+static double hamming_normalized_similarity(const std::string& s1, const std::string& s2, double cutoff)
+{
+    return rf::hamming_normalized_similarity(s1, s2, true, cutoff);
+}
+
+static double jaro_winkler_normalized_similarity(const std::string& s1, const std::string& s2, double cutoff)
+{
+    return rf::jaro_winkler_normalized_similarity(s1, s2, 0.1, cutoff);
+}
+
+#define RAPIDFUZZ_DISTANCE_BENCHMARK(NAME, FUNC, CACHED)                                                     \
+    register_plain(NAME, workload, cutoff, [](const std::string& s1, const std::string& s2, double c) {     \
+        return FUNC(s1, s2, c);                                                                             \
+    });                                                                                                      \
+    register_cached(NAME, workload, cutoff, [](const std::string& s1) { return CACHED(s1); },              \
+                    [](const auto& cached, const std::string& s2, double c) {                               \
+                        return cached.normalized_similarity(s2, c);                                         \
+                    })
+
+/* the fuzz scorers use a score_cutoff in the range 0 - 100 */
+#define RAPIDFUZZ_FUZZ_BENCHMARK(NAME, FUNC, CACHED)                                                         \
+    register_plain(NAME, workload, cutoff, [](const std::string& s1, const std::string& s2, double c) {     \
+        return rf::fuzz::FUNC(s1, s2, c * 100);                                                             \
+    });                                                                                                      \
+    register_cached(NAME, workload, cutoff, [](const std::string& s1) { return rf::fuzz::CACHED(s1); },    \
+                    [](const auto& cached, const std::string& s2, double c) {                               \
+                        return cached.similarity(s2, c * 100);                                              \
+                    })
+
+#define RAPIDFUZZ_MULTI_BENCHMARK(NAME, MULTI)                                                               \
+    register_multi(NAME, workload, cutoff,                                                                   \
+                   [](const std::vector<std::string>& choices) { return rf::experimental::MULTI(choices); }, \
+                   multi_normalized_similarity)
+
+static void register_workload(const Workload& workload)
+{
+    for (double cutoff : score_cutoffs) {
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Levenshtein", levenshtein_normalized_similarity,
+                                     rf::CachedLevenshtein<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Indel", rf::indel_normalized_similarity, rf::CachedIndel<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("LCSseq", rf::lcs_seq_normalized_similarity, rf::CachedLCSseq<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("OSA", rf::osa_normalized_similarity, rf::CachedOSA<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("DamerauLevenshtein",
+                                     rf::experimental::damerau_levenshtein_normalized_similarity,
+                                     rf::experimental::CachedDamerauLevenshtein<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Hamming", hamming_normalized_similarity, rf::CachedHamming<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Jaro", rf::jaro_normalized_similarity, rf::CachedJaro<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("JaroWinkler", jaro_winkler_normalized_similarity,
+                                     rf::CachedJaroWinkler<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Prefix", rf::prefix_normalized_similarity, rf::CachedPrefix<char>);
+        RAPIDFUZZ_DISTANCE_BENCHMARK("Postfix", rf::postfix_normalized_similarity, rf::CachedPostfix<char>);
+
+        RAPIDFUZZ_FUZZ_BENCHMARK("Ratio", ratio, CachedRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("PartialRatio", partial_ratio, CachedPartialRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("TokenSortRatio", token_sort_ratio, CachedTokenSortRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("PartialTokenSortRatio", partial_token_sort_ratio,
+                                 CachedPartialTokenSortRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("TokenSetRatio", token_set_ratio, CachedTokenSetRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("PartialTokenSetRatio", partial_token_set_ratio,
+                                 CachedPartialTokenSetRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("TokenRatio", token_ratio, CachedTokenRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("PartialTokenRatio", partial_token_ratio, CachedPartialTokenRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("WRatio", WRatio, CachedWRatio<char>);
+        RAPIDFUZZ_FUZZ_BENCHMARK("QRatio", QRatio, CachedQRatio<char>);
+
+#ifdef RAPIDFUZZ_SIMD
+        RAPIDFUZZ_MULTI_BENCHMARK("Levenshtein", MultiScorerLevenshtein<char>);
+        RAPIDFUZZ_MULTI_BENCHMARK("Indel", MultiScorerIndel<char>);
+        RAPIDFUZZ_MULTI_BENCHMARK("LCSseq", MultiScorerLCSseq<char>);
+        RAPIDFUZZ_MULTI_BENCHMARK("OSA", MultiScorerOSA<char>);
+        RAPIDFUZZ_MULTI_BENCHMARK("Jaro", MultiScorerJaro<char>);
+        RAPIDFUZZ_MULTI_BENCHMARK("JaroWinkler", MultiScorerJaroWinkler<char>);
+
+        register_simd_multi<rf::experimental::MultiHamming>("Hamming", workload, cutoff,
+                                                            multi_normalized_similarity);
+        register_simd_multi<rf::experimental::MultiDamerauLevenshtein>("DamerauLevenshtein", workload, cutoff,
+                                                                       multi_normalized_similarity);
+
+        register_simd_multi<rf::fuzz::experimental::MultiRatio>("Ratio", workload, cutoff,
+                                                                multi_fuzz_similarity);
+        register_simd_multi<rf::fuzz::experimental::MultiTokenSortRatio>("TokenSortRatio", workload, cutoff,
+                                                                         multi_fuzz_similarity);
+        register_simd_multi<rf::fuzz::experimental::MultiQRatio>("QRatio", workload, cutoff,
+                                                                 multi_fuzz_similarity);
+#endif
+    }
+}
+
+#undef RAPIDFUZZ_MULTI_BENCHMARK
+#undef RAPIDFUZZ_FUZZ_BENCHMARK
+#undef RAPIDFUZZ_DISTANCE_BENCHMARK
+
+static bool parse_size(const std::string& arg, const std::string& prefix, size_t& value)
+{
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = static_cast<size_t>(std::strtoull(arg.c_str() + prefix.size(), nullptr, 10));
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> corpus_args;
+    std::vector<char*> benchmark_args;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i != 0 && arg.compare(0, 9, "--corpus=") == 0)
+            corpus_args.push_back(arg.substr(9));
+        else if (i != 0 && (parse_size(arg, "--corpus_queries=", query_count) ||
+                            parse_size(arg, "--corpus_choices=", choice_count)))
+            continue;
+        else
+            benchmark_args.push_back(argv[i]);
+    }
+
+    std::vector<Corpus> corpora;
+    for (const auto& arg : corpus_args) {
+        Corpus corpus;
+        if (!load_corpus(arg, corpus)) {
+            std::cerr << "failed to read corpus " << arg << "\n";
+            return 1;
+        }
+        corpora.push_back(std::move(corpus));
+    }
+    if (corpora.empty()) corpora.push_back(ocr_corpus());
+
+    for (const auto& corpus : corpora)
+        for (const auto& workload : make_workloads(corpus))
+            register_workload(workload);
+
+    int benchmark_argc = static_cast<int>(benchmark_args.size());
+    benchmark::Initialize(&benchmark_argc, benchmark_args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchmark_argc, benchmark_args.data())) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -7,9 +7,12 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <rapidfuzz/details/MemoryResource.hpp>
+
 namespace rapidfuzz::detail {
 
-/* hashmap for integers which can only grow, but can't remove elements */
+/* hashmap for integers which can only grow, but can't remove elements. The elements are allocated
+ * from a memory_resource or from the global heap when resource is nullptr */
 template <typename T_Key, typename T_Entry>
 struct GrowingHashmap {
     using key_type = T_Key;
@@ -27,20 +30,24 @@ private:
     int fill;
     int mask;
     MapElem* m_map;
+    memory_resource* m_resource;
 
 public:
-    GrowingHashmap() : used(0), fill(0), mask(-1), m_map(nullptr)
+    explicit GrowingHashmap(memory_resource* resource = nullptr)
+        : used(0), fill(0), mask(-1), m_map(nullptr), m_resource(resource)
     {}
     ~GrowingHashmap()
     {
-        delete[] m_map;
+        deallocate_array(m_resource, m_map, capacity());
     }
 
-    GrowingHashmap(const GrowingHashmap& other) : used(other.used), fill(other.fill), mask(other.mask)
+    GrowingHashmap(const GrowingHashmap& other)
+        : used(other.used), fill(other.fill), mask(other.mask), m_map(nullptr), m_resource(nullptr)
     {
-        int size = mask + 1;
-        m_map = new MapElem[size];
-        std::copy(other.m_map, other.m_map + size, m_map);
+        if (other.m_map) {
+            m_map = allocate_array<MapElem>(m_resource, capacity());
+            std::copy(other.m_map, other.m_map + capacity(), m_map);
+        }
     }
 
     GrowingHashmap(GrowingHashmap&& other) noexcept : GrowingHashmap()
@@ -60,6 +67,7 @@ public:
         std::swap(first.fill, second.fill);
         std::swap(first.mask, second.mask);
         std::swap(first.m_map, second.m_map);
+        std::swap(first.m_resource, second.m_resource);
     }
 
     size_type size() const
@@ -106,7 +114,7 @@ private:
     void allocate()
     {
         mask = min_size - 1;
-        m_map = new MapElem[min_size];
+        m_map = allocate_array<MapElem>(m_resource, min_size);
     }
 
     /**
@@ -136,7 +144,8 @@ private:
             newSize <<= 1;
 
         MapElem* oldMap = m_map;
-        m_map = new MapElem[static_cast<size_t>(newSize)];
+        size_t oldSize = capacity();
+        m_map = allocate_array<MapElem>(m_resource, static_cast<size_t>(newSize));
 
         fill = used;
         mask = newSize - 1;
@@ -151,7 +160,7 @@ private:
             }
 
         used = fill;
-        delete[] oldMap;
+        deallocate_array(m_resource, oldMap, oldSize);
     }
 };
 
@@ -160,7 +169,7 @@ struct HybridGrowingHashmap {
     using key_type = T_Key;
     using value_type = T_Entry;
 
-    HybridGrowingHashmap()
+    explicit HybridGrowingHashmap(memory_resource* resource = nullptr) : m_map(resource)
     {
         m_extendedAscii.fill(value_type());
     }
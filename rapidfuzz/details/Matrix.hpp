@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <vector>
 
+#include <rapidfuzz/details/MemoryResource.hpp>
+
 namespace rapidfuzz::detail {
 
 template <typename T, bool IsConst>
@@ -37,27 +39,33 @@ private:
     size_type m_cols;
 };
 
+/**
+ * @brief matrix allocated from a memory_resource or from the global heap when resource is nullptr.
+ * Copies are allocated from the global heap.
+ */
 template <typename T>
 struct BitMatrix {
 
     using value_type = T;
 
-    BitMatrix() : m_rows(0), m_cols(0), m_matrix(nullptr)
+    BitMatrix() : m_rows(0), m_cols(0), m_matrix(nullptr), m_resource(nullptr)
     {}
 
-    BitMatrix(size_t rows, size_t cols, T val) : m_rows(rows), m_cols(cols), m_matrix(nullptr)
+    BitMatrix(size_t rows, size_t cols, T val, memory_resource* resource = nullptr)
+        : m_rows(rows), m_cols(cols), m_matrix(nullptr), m_resource(resource)
     {
-        if (m_rows && m_cols) m_matrix = new T[m_rows * m_cols];
+        if (m_rows && m_cols) m_matrix = allocate_array<T>(m_resource, m_rows * m_cols);
         std::fill_n(m_matrix, m_rows * m_cols, val);
     }
 
-    BitMatrix(const BitMatrix& other) : m_rows(other.m_rows), m_cols(other.m_cols), m_matrix(nullptr)
+    BitMatrix(const BitMatrix& other)
+        : m_rows(other.m_rows), m_cols(other.m_cols), m_matrix(nullptr), m_resource(nullptr)
     {
-        if (m_rows && m_cols) m_matrix = new T[m_rows * m_cols];
+        if (m_rows && m_cols) m_matrix = allocate_array<T>(m_resource, m_rows * m_cols);
         std::copy(other.m_matrix, other.m_matrix + m_rows * m_cols, m_matrix);
     }
 
-    BitMatrix(BitMatrix&& other) noexcept : m_rows(0), m_cols(0), m_matrix(nullptr)
+    BitMatrix(BitMatrix&& other) noexcept : m_rows(0), m_cols(0), m_matrix(nullptr), m_resource(nullptr)
     {
         other.swap(*this);
     }
@@ -81,11 +89,12 @@ struct BitMatrix {
         swap(m_rows, rhs.m_rows);
         swap(m_cols, rhs.m_cols);
         swap(m_matrix, rhs.m_matrix);
+        swap(m_resource, rhs.m_resource);
     }
 
     ~BitMatrix()
     {
-        delete[] m_matrix;
+        deallocate_array(m_resource, m_matrix, m_rows * m_cols);
     }
 
     BitMatrixView<value_type, false> operator[](size_t row) noexcept
@@ -110,10 +119,21 @@ struct BitMatrix {
         return m_cols;
     }
 
+    T* data() noexcept
+    {
+        return m_matrix;
+    }
+
+    const T* data() const noexcept
+    {
+        return m_matrix;
+    }
+
 private:
     size_t m_rows;
     size_t m_cols;
     T* m_matrix;
+    memory_resource* m_resource;
 };
 
 template <typename T>
@@ -123,7 +143,8 @@ struct ShiftedBitMatrix {
     ShiftedBitMatrix()
     {}
 
-    ShiftedBitMatrix(size_t rows, size_t cols, T val) : m_matrix(rows, cols, val), m_offsets(rows)
+    ShiftedBitMatrix(size_t rows, size_t cols, T val, memory_resource* resource = nullptr)
+        : m_matrix(rows, cols, val, resource), m_offsets(rows, resource)
     {}
 
     ShiftedBitMatrix(const ShiftedBitMatrix& other) : m_matrix(other.m_matrix), m_offsets(other.m_offsets)
@@ -193,7 +214,7 @@ struct ShiftedBitMatrix {
 
 private:
     BitMatrix<value_type> m_matrix;
-    std::vector<ptrdiff_t> m_offsets;
+    std::vector<ptrdiff_t, ResourceAllocator<ptrdiff_t>> m_offsets;
 };
 
 } // namespace rapidfuzz::detail
\ No newline at end of file
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright (c) 2022 Max Bachmann */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__has_include)
+#    if __has_include(<memory_resource>)
+#        include <memory_resource>
+#    endif
+#endif
+
+namespace rapidfuzz {
+
+#if defined(__cpp_lib_memory_resource)
+#    define RAPIDFUZZ_HAS_MEMORY_RESOURCE
+
+/**
+ * @brief memory resource used by the allocator aware types like the cached scorers or Editops,
+ * e.g. a std::pmr::monotonic_buffer_resource to free many short lived scorers in one reset.
+ * Passing nullptr uses the global heap.
+ */
+using memory_resource = std::pmr::memory_resource;
+#else
+/* std::pmr is not available in the standard library, so only nullptr can be passed */
+struct memory_resource;
+#endif
+
+namespace detail {
+
+/**
+ * @brief allocator which allocates from a memory_resource or from the global heap when no
+ * memory_resource is passed
+ *
+ * @details
+ * The memory_resource moves together with the allocated memory when moving or swapping containers.
+ * Copies of a container use the global heap, so they can outlive the memory_resource.
+ */
+template <typename T>
+struct ResourceAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    ResourceAllocator(memory_resource* resource = nullptr) noexcept : m_resource(resource)
+    {}
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) noexcept : m_resource(other.resource())
+    {}
+
+    T* allocate(size_t n)
+    {
+#ifdef RAPIDFUZZ_HAS_MEMORY_RESOURCE
+        if (m_resource) {
+            if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+            return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+        }
+#endif
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+#ifdef RAPIDFUZZ_HAS_MEMORY_RESOURCE
+        if (m_resource) return m_resource->deallocate(p, n * sizeof(T), alignof(T));
+#endif
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    ResourceAllocator select_on_container_copy_construction() const noexcept
+    {
+        return ResourceAllocator();
+    }
+
+    memory_resource* resource() const noexcept
+    {
+        return m_resource;
+    }
+
+    template <typename U>
+    friend bool operator==(const ResourceAllocator& a, const ResourceAllocator<U>& b) noexcept
+    {
+        return a.resource() == b.resource();
+    }
+
+    template <typename U>
+    friend bool operator!=(const ResourceAllocator& a, const ResourceAllocator<U>& b) noexcept
+    {
+        return a.resource() != b.resource();
+    }
+
+private:
+    memory_resource* m_resource;
+};
+
+/**
+ * @brief allocates an array of count default initialized elements
+ */
+template <typename T>
+T* allocate_array(memory_resource* resource, size_t count)
+{
+    static_assert(std::is_trivially_destructible_v<T>);
+    T* arr = ResourceAllocator<T>(resource).allocate(count);
+    std::uninitialized_default_construct_n(arr, count);
+    return arr;
+}
+
+template <typename T>
+void deallocate_array(memory_resource* resource, T* arr, size_t count) noexcept
+{
+    if (arr) ResourceAllocator<T>(resource).deallocate(arr, count);
+}
+
+} // namespace detail
+} // namespace rapidfuzz
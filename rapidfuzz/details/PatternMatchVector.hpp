@@ -2,12 +2,18 @@
 /* Copyright (c) 2022 Max Bachmann */
 
 #pragma once
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <stdint.h>
 #include <stdio.h>
+#include <type_traits>
 
 #include <rapidfuzz/details/GrowingHashmap.hpp>
 #include <rapidfuzz/details/Matrix.hpp>
+#include <rapidfuzz/details/MemoryResource.hpp>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/intrinsics.hpp>
 
@@ -31,6 +37,15 @@ struct BitvectorHashmap {
         return m_map[i].value;
     }
 
+    /**
+     * @brief lookups of missing keys only terminate when the map has an empty slot. Maps filled
+     * using operator[] hold at most 64 keys, so this only fails for corrupted serialized data
+     */
+    bool has_empty_slot() const noexcept
+    {
+        return std::any_of(m_map.begin(), m_map.end(), [](const MapElem& elem) { return !elem.value; });
+    }
+
 private:
     /**
      * lookup key inside the hashmap using a similar collision resolution
@@ -58,6 +73,10 @@ private:
     std::array<MapElem, 128> m_map;
 };
 
+/* BitvectorHashmap is stored as is in serialized BlockPatternMatchVectors */
+static_assert(std::is_trivially_copyable_v<BitvectorHashmap> && std::is_standard_layout_v<BitvectorHashmap> &&
+              sizeof(BitvectorHashmap) == 128 * 2 * sizeof(uint64_t));
+
 struct PatternMatchVector {
     PatternMatchVector() : m_extendedAscii()
     {}
@@ -132,22 +151,259 @@ private:
     std::array<uint64_t, 256> m_extendedAscii;
 };
 
+/* maps every extended ascii character to its own row of the bitvectors */
+inline constexpr std::array<uint8_t, 256> ascii_identity_index = [] {
+    std::array<uint8_t, 256> index = {};
+    for (size_t i = 0; i < index.size(); ++i)
+        index[i] = static_cast<uint8_t>(i);
+    return index;
+}();
+
+/**
+ * @brief bitvectors of the positions of each character in a string split into blocks of 64 characters
+ *
+ * @details
+ * The bitvectors of the extended ascii characters are looked up using an index, which maps each
+ * character to a row of bitvectors. When constructed from a string, only the characters occurring
+ * in it get a row and all other characters share a row of zeros. So a string with n distinct
+ * characters requires 256 + (n + 1) * 8 bytes per block instead of 2 KiB. When constructed using
+ * the string length, every character has its own row, so characters can be inserted later on.
+ *
+ * The bitvectors are allocated from the passed memory_resource or from the global heap when it is
+ * nullptr. Copies are allocated from the global heap.
+ *
+ * The bitvectors can be serialized into a binary format using serialize(). view() creates
+ * a read only BlockPatternMatchVector from serialized data without copying it, so precomputed
+ * pattern stores can be loaded using mmap. The format stores the fields in the native byte order:
+ *
+ *   SerializedHeader
+ *   uint8_t[256]                        row of each extended ascii character (when ascii_rows != 256)
+ *   uint64_t[ascii_rows][block_count]   bitvectors of the extended ascii characters
+ *   BitvectorHashmap[block_count]       bitvectors of the remaining characters (when map_count != 0)
+ */
 struct BlockPatternMatchVector {
+    struct SerializedHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t block_count;
+        uint64_t map_count;
+        uint64_t ascii_rows;
+    };
+
+    static constexpr uint32_t serialized_magic = 0x564D5042; /* "BPMV" */
+    /* version 2 added ascii_rows and the index of the ascii rows */
+    static constexpr uint32_t serialized_version = 2;
+
     BlockPatternMatchVector() = delete;
 
-    BlockPatternMatchVector(size_t str_len)
-        : m_block_count(ceil_div(str_len, 64)), m_map(nullptr), m_extendedAscii(256, m_block_count, 0)
+    BlockPatternMatchVector(size_t str_len, memory_resource* resource = nullptr)
+        : m_block_count(ceil_div(str_len, 64)),
+          m_map(nullptr),
+          m_index(nullptr),
+          m_extendedAscii(256, m_block_count, 0, resource),
+          m_ascii_data(m_extendedAscii.data()),
+          m_ascii_index(ascii_identity_index.data()),
+          m_map_data(nullptr),
+          m_resource(resource)
     {}
 
     template <typename InputIt>
-    BlockPatternMatchVector(const Range<InputIt>& s) : BlockPatternMatchVector(s.size())
+    BlockPatternMatchVector(const Range<InputIt>& s, memory_resource* resource = nullptr)
+        : m_block_count(ceil_div(s.size(), 64)),
+          m_map(nullptr),
+          m_index(nullptr),
+          m_extendedAscii(),
+          m_ascii_data(nullptr),
+          m_ascii_index(ascii_identity_index.data()),
+          m_map_data(nullptr),
+          m_resource(resource)
     {
+        std::array<uint8_t, 256> index = {};
+        size_t ascii_rows = 1;
+        for (const auto& ch : s) {
+            int key = extended_ascii(ch);
+            if (key >= 0 && !index[static_cast<size_t>(key)] && ascii_rows < 256)
+                index[static_cast<size_t>(key)] = static_cast<uint8_t>(ascii_rows++);
+        }
+
+        /* the compact layout is only possible when at least one character does not occur */
+        if (ascii_rows < 256) {
+            m_index = allocate_array<uint8_t>(m_resource, 256);
+            std::copy(index.begin(), index.end(), m_index);
+            m_ascii_index = m_index;
+        }
+        else
+            ascii_rows = 256;
+
+        m_extendedAscii = BitMatrix<uint64_t>(ascii_rows, m_block_count, 0, m_resource);
+        m_ascii_data = m_extendedAscii.data();
         insert(s);
     }
 
+    BlockPatternMatchVector(const BlockPatternMatchVector& other)
+        : m_block_count(other.m_block_count),
+          m_map(nullptr),
+          m_index(nullptr),
+          m_extendedAscii(other.m_extendedAscii),
+          m_ascii_data(other.m_ascii_data),
+          m_ascii_index(other.m_ascii_index),
+          m_map_data(other.m_map_data),
+          m_resource(nullptr)
+    {
+        /* views keep pointing to the serialized data */
+        if (!other.is_view()) m_ascii_data = m_extendedAscii.data();
+
+        if (other.m_index) {
+            m_index = allocate_array<uint8_t>(m_resource, 256);
+            std::copy(other.m_index, other.m_index + 256, m_index);
+            m_ascii_index = m_index;
+        }
+
+        if (other.m_map) {
+            m_map = allocate_array<BitvectorHashmap>(m_resource, m_block_count);
+            std::copy(other.m_map, other.m_map + m_block_count, m_map);
+            m_map_data = m_map;
+        }
+    }
+
+    BlockPatternMatchVector(BlockPatternMatchVector&& other) noexcept
+        : m_block_count(0),
+          m_map(nullptr),
+          m_index(nullptr),
+          m_extendedAscii(),
+          m_ascii_data(nullptr),
+          m_ascii_index(ascii_identity_index.data()),
+          m_map_data(nullptr),
+          m_resource(nullptr)
+    {
+        other.swap(*this);
+    }
+
+    BlockPatternMatchVector& operator=(const BlockPatternMatchVector& other)
+    {
+        BlockPatternMatchVector temp = other;
+        temp.swap(*this);
+        return *this;
+    }
+
+    BlockPatternMatchVector& operator=(BlockPatternMatchVector&& other) noexcept
+    {
+        other.swap(*this);
+        return *this;
+    }
+
+    void swap(BlockPatternMatchVector& rhs) noexcept
+    {
+        using std::swap;
+        swap(m_block_count, rhs.m_block_count);
+        swap(m_map, rhs.m_map);
+        swap(m_index, rhs.m_index);
+        /* swapping the BitMatrix does not move the allocation, so the data pointers stay valid */
+        swap(m_extendedAscii, rhs.m_extendedAscii);
+        swap(m_ascii_data, rhs.m_ascii_data);
+        swap(m_ascii_index, rhs.m_ascii_index);
+        swap(m_map_data, rhs.m_map_data);
+        swap(m_resource, rhs.m_resource);
+    }
+
     ~BlockPatternMatchVector()
     {
-        delete[] m_map;
+        deallocate_array(m_resource, m_map, m_block_count);
+        deallocate_array(m_resource, m_index, 256);
+    }
+
+    /**
+     * @brief creates a read only BlockPatternMatchVector from data written by serialize()
+     *
+     * @details
+     * The data is not copied, so it has to outlive the returned object and all its copies.
+     * The data has to be aligned to 8 bytes, which is the case for memory returned by mmap.
+     *
+     * @throws std::invalid_argument when the data is not a valid serialized BlockPatternMatchVector
+     */
+    static BlockPatternMatchVector view(const void* data, size_t size)
+    {
+        if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0)
+            throw std::invalid_argument("serialized BlockPatternMatchVector has to be aligned to 8 bytes");
+        if (size < sizeof(SerializedHeader))
+            throw std::invalid_argument("serialized BlockPatternMatchVector is truncated");
+
+        SerializedHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != serialized_magic)
+            throw std::invalid_argument("data is no serialized BlockPatternMatchVector");
+        if (header.version != serialized_version)
+            throw std::invalid_argument("unsupported BlockPatternMatchVector version");
+        if ((header.map_count != 0 && header.map_count != header.block_count) || header.ascii_rows == 0 ||
+            header.ascii_rows > 256)
+            throw std::invalid_argument("serialized BlockPatternMatchVector is corrupted");
+
+        size_t max_blocks = (std::numeric_limits<size_t>::max() - sizeof(SerializedHeader) - 256) /
+                            (256 * sizeof(uint64_t) + sizeof(BitvectorHashmap));
+        size_t block_count = static_cast<size_t>(header.block_count);
+        size_t rows = static_cast<size_t>(header.ascii_rows);
+        bool has_map = header.map_count != 0;
+        if (header.block_count > max_blocks || size < serialized_size(block_count, rows, has_map))
+            throw std::invalid_argument("serialized BlockPatternMatchVector is truncated");
+
+        const auto* bytes = static_cast<const unsigned char*>(data) + sizeof(SerializedHeader);
+        BlockPatternMatchVector PM(0);
+        PM.m_block_count = block_count;
+        if (rows != 256) {
+            if (std::any_of(bytes, bytes + 256, [&](uint8_t row) { return row >= rows; }))
+                throw std::invalid_argument("serialized BlockPatternMatchVector is corrupted");
+            PM.m_ascii_index = bytes;
+            bytes += 256;
+        }
+
+        PM.m_ascii_data = reinterpret_cast<const uint64_t*>(bytes);
+        if (has_map) {
+            PM.m_map_data =
+                reinterpret_cast<const BitvectorHashmap*>(bytes + rows * block_count * sizeof(uint64_t));
+            if (!std::all_of(PM.m_map_data, PM.m_map_data + block_count,
+                             [](const BitvectorHashmap& map) { return map.has_empty_slot(); }))
+                throw std::invalid_argument("serialized BlockPatternMatchVector is corrupted");
+        }
+        return PM;
+    }
+
+    /**
+     * @return number of bytes written by serialize()
+     */
+    size_t serialized_size() const noexcept
+    {
+        return serialized_size(m_block_count, ascii_rows(), m_map_data != nullptr);
+    }
+
+    /**
+     * @brief writes the bitvectors into dest, which has to provide serialized_size() bytes
+     */
+    void serialize(void* dest) const noexcept
+    {
+        auto* bytes = static_cast<unsigned char*>(dest);
+        SerializedHeader header = {serialized_magic, serialized_version, m_block_count,
+                                   m_map_data ? m_block_count : 0, ascii_rows()};
+        std::memcpy(bytes, &header, sizeof(header));
+        bytes += sizeof(header);
+
+        if (header.ascii_rows != 256) {
+            std::memcpy(bytes, m_ascii_index, 256);
+            bytes += 256;
+        }
+
+        size_t ascii_size = header.ascii_rows * m_block_count * sizeof(uint64_t);
+        if (ascii_size) std::memcpy(bytes, m_ascii_data, ascii_size);
+        bytes += ascii_size;
+
+        if (m_map_data) std::memcpy(bytes, m_map_data, m_block_count * sizeof(BitvectorHashmap));
+    }
+
+    /**
+     * @return true when the object references serialized data created using view()
+     */
+    bool is_view() const noexcept
+    {
+        return m_ascii_data != m_extendedAscii.data();
     }
 
     size_t size() const noexcept
@@ -155,6 +411,15 @@ struct BlockPatternMatchVector {
         return m_block_count;
     }
 
+    /**
+     * @return number of rows of bitvectors used for the extended ascii characters
+     */
+    size_t ascii_rows() const noexcept
+    {
+        if (m_ascii_index == ascii_identity_index.data()) return 256;
+        return static_cast<size_t>(*std::max_element(m_ascii_index, m_ascii_index + 256)) + 1;
+    }
+
     template <typename CharT>
     void insert(size_t block, CharT ch, int pos) noexcept
     {
@@ -184,10 +449,17 @@ struct BlockPatternMatchVector {
     void insert_mask(size_t block, CharT key, uint64_t mask) noexcept
     {
         assert(block < size());
-        if (key >= 0 && key <= 255)
-            m_extendedAscii[static_cast<uint8_t>(key)][block] |= mask;
+        assert(!is_view());
+        if (key >= 0 && key <= 255) {
+            /* in the compact layout only characters of the original string can be inserted */
+            assert(m_ascii_index == ascii_identity_index.data() || m_ascii_index[static_cast<uint8_t>(key)]);
+            m_extendedAscii[m_ascii_index[static_cast<uint8_t>(key)]][block] |= mask;
+        }
         else {
-            if (!m_map) m_map = new BitvectorHashmap[m_block_count];
+            if (!m_map) {
+                m_map = allocate_array<BitvectorHashmap>(m_resource, m_block_count);
+                m_map_data = m_map;
+            }
             m_map[block][key] |= mask;
         }
     }
@@ -201,9 +473,9 @@ struct BlockPatternMatchVector {
     uint64_t get(size_t block, CharT key) const noexcept
     {
         if (key >= 0 && key <= 255)
-            return m_extendedAscii[static_cast<uint8_t>(key)][block];
-        else if (m_map)
-            return m_map[block].get(key);
+            return m_ascii_data[m_ascii_index[static_cast<uint8_t>(key)] * m_block_count + block];
+        else if (m_map_data)
+            return m_map_data[block].get(key);
         else
             return 0;
     }
@@ -214,9 +486,45 @@ struct BlockPatternMatchVector {
     }
 
 private:
+    static size_t serialized_size(size_t block_count, size_t ascii_rows, bool has_map) noexcept
+    {
+        size_t size = sizeof(SerializedHeader) + ascii_rows * block_count * sizeof(uint64_t);
+        if (ascii_rows != 256) size += 256;
+        if (has_map) size += block_count * sizeof(BitvectorHashmap);
+        return size;
+    }
+
+    /* extended ascii value of a character or -1 for other characters */
+    template <typename CharT>
+    static int extended_ascii(CharT key) noexcept
+    {
+        return (key >= 0 && key <= 255) ? static_cast<int>(key) : -1;
+    }
+
+    static int extended_ascii(char key) noexcept
+    {
+        return static_cast<uint8_t>(key);
+    }
+
     size_t m_block_count;
     BitvectorHashmap* m_map;
+    uint8_t* m_index;
     BitMatrix<uint64_t> m_extendedAscii;
+    /* point either into the owned storage, to ascii_identity_index or into serialized data */
+    const uint64_t* m_ascii_data;
+    const uint8_t* m_ascii_index;
+    const BitvectorHashmap* m_map_data;
+    memory_resource* m_resource;
 };
 
+/**
+ * @brief checks that a precomputed BlockPatternMatchVector passed to a cached scorer
+ * matches the length of the string
+ */
+inline void check_pattern_match_vector(const BlockPatternMatchVector& PM, size_t str_len)
+{
+    if (PM.size() != ceil_div(str_len, 64))
+        throw std::invalid_argument("BlockPatternMatchVector does not match the string length");
+}
+
 } // namespace rapidfuzz::detail
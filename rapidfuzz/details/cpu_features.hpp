@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+namespace rapidfuzz::detail {
+
+/**
+ * @brief instruction set extensions of the cpu the program is running on, which are
+ * relevant for the selection of the simd implementation
+ */
+struct CpuFeatures {
+    bool avx2 = false;
+    bool avx512bw = false; /* AVX512F + AVX512BW */
+};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+inline CpuFeatures detect_cpu_features() noexcept
+{
+    CpuFeatures features;
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7) return features;
+
+    /* the os has to save the ymm / zmm registers on context switches */
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave) return features;
+
+    unsigned long long xcr0 = _xgetbv(0);
+    bool os_avx = (xcr0 & 0x06) == 0x06;
+    bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+
+    __cpuidex(info, 7, 0);
+    features.avx2 = os_avx && (info[1] & (1 << 5));
+    features.avx512bw = os_avx512 && (info[1] & (1 << 16)) && (info[1] & (1 << 30));
+    return features;
+}
+#else
+inline CpuFeatures detect_cpu_features() noexcept
+{
+    CpuFeatures features;
+    /* __builtin_cpu_supports checks the os support of the registers as well */
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512bw = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    return features;
+}
+#endif
+
+/**
+ * @brief features of the current cpu. They are only detected on the first call.
+ */
+inline const CpuFeatures& cpu_features() noexcept
+{
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
+
+} // namespace rapidfuzz::detail
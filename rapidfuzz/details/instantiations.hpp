@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include <rapidfuzz/distance/DamerauLevenshtein.hpp>
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/distance/Jaro.hpp>
+#include <rapidfuzz/distance/JaroWinkler.hpp>
+#include <rapidfuzz/distance/LCSseq.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/distance/OSA.hpp>
+
+/*
+ * List of the algorithms, which are precompiled in the rapidfuzz_static library. All scorers
+ * forward to them, so they are only instantiated for these iterators:
+ *   - `const CharT*` (e.g. pointers and std::basic_string_view<CharT>)
+ *   - `std::basic_string<CharT>::const_iterator`
+ * and s1 of the cached scorers.
+ *
+ * When RAPIDFUZZ_EXTERN_TEMPLATES is defined (done by linking against rapidfuzz_static) they are
+ * declared as extern templates, so they are not compiled in every translation unit.
+ */
+
+namespace rapidfuzz::detail {
+
+template <typename CharT>
+using string_iter_t = typename std::basic_string<CharT>::const_iterator;
+
+/* iterator over s1 of the cached scorers */
+template <typename CharT>
+using cached_iter_t = typename std::vector<CharT, ResourceAllocator<CharT>>::const_iterator;
+
+} // namespace rapidfuzz::detail
+
+#define RAPIDFUZZ_INSTANTIATE_RANGES(EXTERN, It1, It2)                                                      \
+    EXTERN template size_t levenshtein_distance(const Range<It1>&, const Range<It2>&,                       \
+                                                LevenshteinWeightTable, size_t, size_t);                    \
+    EXTERN template Editops levenshtein_editops(const Range<It1>&, const Range<It2>&, size_t,               \
+                                                memory_resource*, size_t, size_t);                          \
+    EXTERN template size_t lcs_seq_similarity(Range<It1>, Range<It2>, size_t);                              \
+    EXTERN template Editops lcs_seq_editops(Range<It1>, Range<It2>, memory_resource*);                      \
+    EXTERN template size_t osa_hyrroe2003_block(const BlockPatternMatchVector&, const Range<It1>&,          \
+                                                const Range<It2>&, size_t);                                 \
+    EXTERN template size_t damerau_levenshtein_distance(Range<It1>, Range<It2>, size_t);                    \
+    EXTERN template double jaro_similarity(Range<It1>, Range<It2>, double);                                 \
+    EXTERN template double jaro_winkler_similarity(const Range<It1>&, const Range<It2>&, double, double);
+
+#define RAPIDFUZZ_INSTANTIATE_CACHED(EXTERN, It1, It2)                                                      \
+    EXTERN template size_t uniform_levenshtein_distance(const BlockPatternMatchVector&, Range<It1>,         \
+                                                        Range<It2>, size_t, size_t);                        \
+    EXTERN template size_t indel_distance(const BlockPatternMatchVector&, const Range<It1>&,                \
+                                          const Range<It2>&, size_t);                                       \
+    EXTERN template size_t lcs_seq_similarity(const BlockPatternMatchVector&, Range<It1>, Range<It2>,       \
+                                              size_t);                                                      \
+    EXTERN template size_t osa_hyrroe2003_block(const BlockPatternMatchVector&, const Range<It1>&,          \
+                                                const Range<It2>&, size_t);                                 \
+    EXTERN template size_t damerau_levenshtein_distance(const BlockPatternMatchVector&, Range<It1>,         \
+                                                        Range<It2>, size_t);                                \
+    EXTERN template double jaro_similarity(const BlockPatternMatchVector&, Range<It1>, Range<It2>, double); \
+    EXTERN template double jaro_winkler_similarity(const BlockPatternMatchVector&, const Range<It1>&,       \
+                                                   const Range<It2>&, double, double);
+
+#define RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, CharT)                                                           \
+    RAPIDFUZZ_INSTANTIATE_RANGES(EXTERN, const CharT*, const CharT*)                                        \
+    RAPIDFUZZ_INSTANTIATE_RANGES(EXTERN, string_iter_t<CharT>, string_iter_t<CharT>)                        \
+    RAPIDFUZZ_INSTANTIATE_CACHED(EXTERN, cached_iter_t<CharT>, const CharT*)                                \
+    RAPIDFUZZ_INSTANTIATE_CACHED(EXTERN, cached_iter_t<CharT>, string_iter_t<CharT>)
+
+/* EXTERN is either `extern` for the declarations or empty for the definitions */
+#define RAPIDFUZZ_INSTANTIATE(EXTERN)                                                                       \
+    namespace rapidfuzz::detail {                                                                           \
+    RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, char)                                                                \
+    RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, unsigned char)                                                       \
+    RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, char16_t)                                                            \
+    RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, char32_t)                                                            \
+    RAPIDFUZZ_INSTANTIATE_CHAR(EXTERN, wchar_t)                                                             \
+    }
+
+#ifdef RAPIDFUZZ_EXTERN_TEMPLATES
+RAPIDFUZZ_INSTANTIATE(extern)
+#endif
@@ -1,4 +1,3 @@
-
 /* SPDX-License-Identifier: MIT */
 /* Copyright © 2022 Max Bachmann */
 #pragma once
@@ -6,16 +5,177 @@
 /* RAPIDFUZZ_LTO_HACK is used to differentiate functions between different
  * translation units to avoid warnings when using lto */
 #ifndef RAPIDFUZZ_EXCLUDE_SIMD
-#    if __AVX2__
-#        define RAPIDFUZZ_SIMD
-#        define RAPIDFUZZ_AVX2
-#        define RAPIDFUZZ_LTO_HACK 0
-#        include <rapidfuzz/details/simd_avx2.hpp>
-
-#    elif (defined(_M_AMD64) || defined(_M_X64)) || defined(__SSE2__)
+#    if (defined(_M_AMD64) || defined(_M_X64)) || defined(__SSE2__)
 #        define RAPIDFUZZ_SIMD
 #        define RAPIDFUZZ_SSE2
-#        define RAPIDFUZZ_LTO_HACK 1
+
+/* The wider implementations are compiled using target attributes, so the same binary can use them
+ * without requiring them. The Multi* scorers always use the layout of the widest compiled
+ * implementation, so it has to be independent of the optimization level. Otherwise translation
+ * units compiled with different flags would disagree on the layout of the same types.
+ */
+#        if (defined(_MSC_VER) && !defined(__clang__)) || defined(__GNUC__) || defined(__clang__)
+#            define RAPIDFUZZ_SIMD_TARGETS
+#        endif
+
+/* The implementation is selected based on the cpu at runtime. This relies on the simd kernels being
+ * inlined into the function with the target attribute, since the abi of the vector types differs
+ * between the targets. So it is only enabled for optimized builds. Otherwise the narrowest
+ * implementation processes the wider layout. It can be disabled using RAPIDFUZZ_EXCLUDE_SIMD_DISPATCH,
+ * in which case only the implementations enabled at compile time are used.
+ */
+#        if defined(RAPIDFUZZ_SIMD_TARGETS) && !defined(RAPIDFUZZ_EXCLUDE_SIMD_DISPATCH) &&               \
+            ((defined(_MSC_VER) && !defined(__clang__)) || defined(__OPTIMIZE__))
+#            define RAPIDFUZZ_SIMD_DISPATCH
+#        endif
+
+/* the dispatch mode changes the code of the kernels as well */
+#        if defined(__AVX512F__) && defined(__AVX512BW__)
+#            define RAPIDFUZZ_LTO_HACK_ISA 2
+#        elif defined(__AVX2__)
+#            define RAPIDFUZZ_LTO_HACK_ISA 0
+#        else
+#            define RAPIDFUZZ_LTO_HACK_ISA 1
+#        endif
+
+#        ifdef RAPIDFUZZ_SIMD_DISPATCH
+#            define RAPIDFUZZ_LTO_HACK (RAPIDFUZZ_LTO_HACK_ISA + 3)
+#        else
+#            define RAPIDFUZZ_LTO_HACK RAPIDFUZZ_LTO_HACK_ISA
+#        endif
+
+/* the avx512 implementation can be disabled using RAPIDFUZZ_EXCLUDE_AVX512, since
+ * the reduced clock speed on some cpus can outweigh the wider vectors */
+#        if defined(__AVX512F__) && defined(__AVX512BW__) && !defined(RAPIDFUZZ_EXCLUDE_AVX512)
+#            define RAPIDFUZZ_AVX512
+#        elif defined(RAPIDFUZZ_SIMD_TARGETS) && !defined(RAPIDFUZZ_EXCLUDE_AVX512)
+#            define RAPIDFUZZ_AVX512
+#            define RAPIDFUZZ_AVX512_TARGET
+#        endif
+
+#        if defined(__AVX2__)
+#            define RAPIDFUZZ_AVX2
+#        elif defined(RAPIDFUZZ_SIMD_TARGETS)
+#            define RAPIDFUZZ_AVX2
+#            define RAPIDFUZZ_AVX2_TARGET
+#        endif
+
+/* everything included by the simd implementations has to be included before switching the target.
+ * Otherwise it could be compiled for the wider instruction set as well */
+#        include <array>
+#        include <bitset>
+#        include <limits>
+#        include <ostream>
+#        include <rapidfuzz/details/cpu_features.hpp>
+#        include <rapidfuzz/details/intrinsics.hpp>
+#        include <stdint.h>
+#        if defined(RAPIDFUZZ_AVX2) || defined(RAPIDFUZZ_AVX512)
+#            include <immintrin.h>
+#        endif
+
 #        include <rapidfuzz/details/simd_sse2.hpp>
+
+#        ifdef RAPIDFUZZ_AVX2
+#            if defined(RAPIDFUZZ_AVX2_TARGET) && defined(__clang__)
+#                pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#            elif defined(RAPIDFUZZ_AVX2_TARGET) && defined(__GNUC__)
+#                pragma GCC push_options
+#                pragma GCC target("avx2")
+#            endif
+#            include <rapidfuzz/details/simd_avx2.hpp>
+#            if defined(RAPIDFUZZ_AVX2_TARGET) && defined(__clang__)
+#                pragma clang attribute pop
+#            elif defined(RAPIDFUZZ_AVX2_TARGET) && defined(__GNUC__)
+#                pragma GCC pop_options
+#            endif
+#        endif
+
+#        ifdef RAPIDFUZZ_AVX512
+#            if defined(RAPIDFUZZ_AVX512_TARGET) && defined(__clang__)
+#                pragma clang attribute push(__attribute__((target("avx2,avx512f,avx512bw"))),              \
+                                             apply_to = function)
+#            elif defined(RAPIDFUZZ_AVX512_TARGET) && defined(__GNUC__)
+#                pragma GCC push_options
+#                pragma GCC target("avx2,avx512f,avx512bw")
+#            endif
+#            include <rapidfuzz/details/simd_avx512.hpp>
+#            if defined(RAPIDFUZZ_AVX512_TARGET) && defined(__clang__)
+#                pragma clang attribute pop
+#            elif defined(RAPIDFUZZ_AVX512_TARGET) && defined(__GNUC__)
+#                pragma GCC pop_options
+#            endif
+#        endif
+
+#        if defined(__GNUC__) || defined(__clang__)
+#            define RAPIDFUZZ_TARGET_AVX2 __attribute__((target("avx2"), flatten))
+#            define RAPIDFUZZ_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw"), flatten))
+#        else
+#            define RAPIDFUZZ_TARGET_AVX2
+#            define RAPIDFUZZ_TARGET_AVX512
+#        endif
+
+namespace rapidfuzz::detail {
+
+/* tags of the simd implementations, which are passed to the kernels by simd_dispatch */
+struct SimdSSE2 {
+    template <typename T>
+    using native_simd = simd_sse2::native_simd<T>;
+};
+
+#        ifdef RAPIDFUZZ_AVX2
+struct SimdAVX2 {
+    template <typename T>
+    using native_simd = simd_avx2::native_simd<T>;
+};
+
+template <typename Func>
+RAPIDFUZZ_TARGET_AVX2 void simd_invoke_avx2(Func&& func)
+{
+    func(SimdAVX2{});
+}
+#        endif
+
+#        ifdef RAPIDFUZZ_AVX512
+struct SimdAVX512 {
+    template <typename T>
+    using native_simd = simd_avx512::native_simd<T>;
+};
+
+template <typename Func>
+RAPIDFUZZ_TARGET_AVX512 void simd_invoke_avx512(Func&& func)
+{
+    func(SimdAVX512{});
+}
+#        endif
+
+/**
+ * @brief calls func with the tag of the widest simd implementation supported by the cpu
+ *
+ * @details
+ * Implementations which are enabled at compile time are always used. The other compiled
+ * implementations are only used when RAPIDFUZZ_SIMD_DISPATCH is defined. The vector width only affects how many strings are processed at once. The simd scorers
+ * always use the layout of the widest compiled implementation, which is supported by all
+ * narrower implementations.
+ */
+template <typename Func, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void simd_dispatch(Func&& func)
+{
+#        if defined(RAPIDFUZZ_AVX512) && !defined(RAPIDFUZZ_AVX512_TARGET)
+    return simd_invoke_avx512(func);
+#        elif defined(RAPIDFUZZ_AVX512) && defined(RAPIDFUZZ_SIMD_DISPATCH)
+    if (cpu_features().avx512bw) return simd_invoke_avx512(func);
+#        endif
+
+#        if defined(RAPIDFUZZ_AVX2) && !defined(RAPIDFUZZ_AVX2_TARGET)
+    return simd_invoke_avx2(func);
+#        elif defined(RAPIDFUZZ_AVX2) && defined(RAPIDFUZZ_SIMD_DISPATCH)
+    if (cpu_features().avx2) return simd_invoke_avx2(func);
+#        endif
+
+    func(SimdSSE2{});
+}
+
+} // namespace rapidfuzz::detail
+
 #    endif
-#endif
\ No newline at end of file
+#endif
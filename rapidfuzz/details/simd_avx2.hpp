@@ -267,6 +267,14 @@ public:
         _mm256_store_si256(reinterpret_cast<__m256i*>(p), xmm);
     }
 
+    /* bitmask of the size bytes of a and b, which differ */
+    static uint64_t mismatch_mask(const uint8_t* a, const uint8_t* b) noexcept
+    {
+        __m256i a_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        __m256i b_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a_, b_)));
+    }
+
     native_simd operator+(const native_simd b) const noexcept
     {
         return _mm256_add_epi8(xmm, b);
@@ -372,6 +380,13 @@ native_simd<T> andnot(const native_simd<T>& a, const native_simd<T>& b)
     return _mm256_andnot_si256(b, a);
 }
 
+// function blsi: a & -a
+template <typename T>
+native_simd<T> blsi(const native_simd<T>& a) noexcept
+{
+    return a & -a;
+}
+
 static inline native_simd<uint8_t> operator==(const native_simd<uint8_t>& a,
                                               const native_simd<uint8_t>& b) noexcept
 {
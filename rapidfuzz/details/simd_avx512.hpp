@@ -0,0 +1,724 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022 Max Bachmann */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <immintrin.h>
+#include <limits>
+#include <ostream>
+#include <rapidfuzz/details/intrinsics.hpp>
+#include <stdint.h>
+
+namespace rapidfuzz {
+namespace detail {
+namespace simd_avx512 {
+
+/*
+ * requires AVX512F + AVX512BW. When available VPOPCNTDQ / BITALG are used for popcount.
+ * Comparisons are performed into mask registers, which are expanded into a vector
+ * to keep the interface compatible with the sse2 / avx2 implementation.
+ */
+
+template <typename T>
+class native_simd;
+
+template <>
+class native_simd<uint64_t> {
+public:
+    using value_type = uint64_t;
+
+    static constexpr int alignment = 64;
+    static const int size = 8;
+    __m512i xmm;
+
+    native_simd() noexcept
+    {}
+
+    native_simd(__m512i val) noexcept : xmm(val)
+    {}
+
+    native_simd(uint64_t a) noexcept
+    {
+        xmm = _mm512_set1_epi64(static_cast<int64_t>(a));
+    }
+
+    native_simd(const uint64_t* p) noexcept
+    {
+        load(p);
+    }
+
+    operator __m512i() const noexcept
+    {
+        return xmm;
+    }
+
+    native_simd load(const uint64_t* p) noexcept
+    {
+        xmm = _mm512_loadu_si512(reinterpret_cast<const void*>(p));
+        return *this;
+    }
+
+    void store(uint64_t* p) const noexcept
+    {
+        _mm512_store_si512(reinterpret_cast<void*>(p), xmm);
+    }
+
+    native_simd operator+(const native_simd b) const noexcept
+    {
+        return _mm512_add_epi64(xmm, b);
+    }
+
+    native_simd& operator+=(const native_simd b) noexcept
+    {
+        xmm = _mm512_add_epi64(xmm, b);
+        return *this;
+    }
+
+    native_simd operator-(const native_simd b) const noexcept
+    {
+        return _mm512_sub_epi64(xmm, b);
+    }
+
+    native_simd operator-() const noexcept
+    {
+        return _mm512_sub_epi64(_mm512_setzero_si512(), xmm);
+    }
+
+    native_simd& operator-=(const native_simd b) noexcept
+    {
+        xmm = _mm512_sub_epi64(xmm, b);
+        return *this;
+    }
+};
+
+template <>
+class native_simd<uint32_t> {
+public:
+    using value_type = uint32_t;
+
+    static constexpr int alignment = 64;
+    static const int size = 16;
+    __m512i xmm;
+
+    native_simd() noexcept
+    {}
+
+    native_simd(__m512i val) noexcept : xmm(val)
+    {}
+
+    native_simd(uint32_t a) noexcept
+    {
+        xmm = _mm512_set1_epi32(static_cast<int>(a));
+    }
+
+    native_simd(const uint64_t* p) noexcept
+    {
+        load(p);
+    }
+
+    operator __m512i() const noexcept
+    {
+        return xmm;
+    }
+
+    native_simd load(const uint64_t* p) noexcept
+    {
+        xmm = _mm512_loadu_si512(reinterpret_cast<const void*>(p));
+        return *this;
+    }
+
+    void store(uint32_t* p) const noexcept
+    {
+        _mm512_store_si512(reinterpret_cast<void*>(p), xmm);
+    }
+
+    native_simd operator+(const native_simd b) const noexcept
+    {
+        return _mm512_add_epi32(xmm, b);
+    }
+
+    native_simd& operator+=(const native_simd b) noexcept
+    {
+        xmm = _mm512_add_epi32(xmm, b);
+        return *this;
+    }
+
+    native_simd operator-() const noexcept
+    {
+        return _mm512_sub_epi32(_mm512_setzero_si512(), xmm);
+    }
+
+    native_simd operator-(const native_simd b) const noexcept
+    {
+        return _mm512_sub_epi32(xmm, b);
+    }
+
+    native_simd& operator-=(const native_simd b) noexcept
+    {
+        xmm = _mm512_sub_epi32(xmm, b);
+        return *this;
+    }
+};
+
+template <>
+class native_simd<uint16_t> {
+public:
+    using value_type = uint16_t;
+
+    static constexpr int alignment = 64;
+    static const int size = 32;
+    __m512i xmm;
+
+    native_simd() noexcept
+    {}
+
+    native_simd(__m512i val) noexcept : xmm(val)
+    {}
+
+    native_simd(uint16_t a) noexcept
+    {
+        xmm = _mm512_set1_epi16(static_cast<short>(a));
+    }
+
+    native_simd(const uint64_t* p) noexcept
+    {
+        load(p);
+    }
+
+    operator __m512i() const noexcept
+    {
+        return xmm;
+    }
+
+    native_simd load(const uint64_t* p) noexcept
+    {
+        xmm = _mm512_loadu_si512(reinterpret_cast<const void*>(p));
+        return *this;
+    }
+
+    void store(uint16_t* p) const noexcept
+    {
+        _mm512_store_si512(reinterpret_cast<void*>(p), xmm);
+    }
+
+    native_simd operator+(const native_simd b) const noexcept
+    {
+        return _mm512_add_epi16(xmm, b);
+    }
+
+    native_simd& operator+=(const native_simd b) noexcept
+    {
+        xmm = _mm512_add_epi16(xmm, b);
+        return *this;
+    }
+
+    native_simd operator-(const native_simd b) const noexcept
+    {
+        return _mm512_sub_epi16(xmm, b);
+    }
+
+    native_simd operator-() const noexcept
+    {
+        return _mm512_sub_epi16(_mm512_setzero_si512(), xmm);
+    }
+
+    native_simd& operator-=(const native_simd b) noexcept
+    {
+        xmm = _mm512_sub_epi16(xmm, b);
+        return *this;
+    }
+};
+
+template <>
+class native_simd<uint8_t> {
+public:
+    using value_type = uint8_t;
+
+    static constexpr int alignment = 64;
+    static const int size = 64;
+    __m512i xmm;
+
+    native_simd() noexcept
+    {}
+
+    native_simd(__m512i val) noexcept : xmm(val)
+    {}
+
+    native_simd(uint8_t a) noexcept
+    {
+        xmm = _mm512_set1_epi8(static_cast<char>(a));
+    }
+
+    native_simd(const uint64_t* p) noexcept
+    {
+        load(p);
+    }
+
+    operator __m512i() const noexcept
+    {
+        return xmm;
+    }
+
+    native_simd load(const uint64_t* p) noexcept
+    {
+        xmm = _mm512_loadu_si512(reinterpret_cast<const void*>(p));
+        return *this;
+    }
+
+    void store(uint8_t* p) const noexcept
+    {
+        _mm512_store_si512(reinterpret_cast<void*>(p), xmm);
+    }
+
+    /* bitmask of the size bytes of a and b, which differ */
+    static uint64_t mismatch_mask(const uint8_t* a, const uint8_t* b) noexcept
+    {
+        __m512i a_ = _mm512_loadu_si512(reinterpret_cast<const void*>(a));
+        __m512i b_ = _mm512_loadu_si512(reinterpret_cast<const void*>(b));
+        return _mm512_cmpneq_epi8_mask(a_, b_);
+    }
+
+    native_simd operator+(const native_simd b) const noexcept
+    {
+        return _mm512_add_epi8(xmm, b);
+    }
+
+    native_simd& operator+=(const native_simd b) noexcept
+    {
+        xmm = _mm512_add_epi8(xmm, b);
+        return *this;
+    }
+
+    native_simd operator-(const native_simd b) const noexcept
+    {
+        return _mm512_sub_epi8(xmm, b);
+    }
+
+    native_simd operator-() const noexcept
+    {
+        return _mm512_sub_epi8(_mm512_setzero_si512(), xmm);
+    }
+
+    native_simd& operator-=(const native_simd b) noexcept
+    {
+        xmm = _mm512_sub_epi8(xmm, b);
+        return *this;
+    }
+};
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const native_simd<T>& a)
+{
+    alignas(native_simd<T>::alignment) std::array<T, native_simd<T>::size> res;
+    a.store(&res[0]);
+
+    for (size_t i = res.size() - 1; i != 0; i--)
+        os << std::bitset<std::numeric_limits<T>::digits>(res[i]) << "|";
+
+    os << std::bitset<std::numeric_limits<T>::digits>(res[0]);
+    return os;
+}
+
+/* The unmasked 32 / 64 bit shift, min / max and andnot intrinsics are implemented using
+ * _mm512_undefined_epi32 in gcc, which leads to false positive -Wmaybe-uninitialized warnings.
+ * So the zero masked versions with all lanes enabled are used instead, which compile to the same
+ * instructions. andnot is implemented using ternarylogic for the same reason */
+static constexpr __mmask16 all_lanes32 = 0xFFFF;
+static constexpr __mmask8 all_lanes64 = 0xFF;
+
+/* expand the comparison masks into vectors */
+static inline native_simd<uint8_t> mask_to_vec8(__mmask64 mask) noexcept
+{
+    return _mm512_maskz_mov_epi8(mask, _mm512_set1_epi32(-1));
+}
+
+static inline native_simd<uint16_t> mask_to_vec16(__mmask32 mask) noexcept
+{
+    return _mm512_maskz_mov_epi16(mask, _mm512_set1_epi32(-1));
+}
+
+static inline native_simd<uint32_t> mask_to_vec32(__mmask16 mask) noexcept
+{
+    return _mm512_maskz_mov_epi32(mask, _mm512_set1_epi32(-1));
+}
+
+static inline native_simd<uint64_t> mask_to_vec64(__mmask8 mask) noexcept
+{
+    return _mm512_maskz_mov_epi64(mask, _mm512_set1_epi32(-1));
+}
+
+template <typename T>
+__m512i hadd_impl(__m512i x) noexcept;
+
+template <>
+inline __m512i hadd_impl<uint8_t>(__m512i x) noexcept
+{
+    return x;
+}
+
+template <>
+inline __m512i hadd_impl<uint16_t>(__m512i x) noexcept
+{
+    const __m512i mask = _mm512_set1_epi16(0x001f);
+    __m512i y = _mm512_bsrli_epi128(x, 1);
+    x = _mm512_add_epi16(x, y);
+    return _mm512_and_si512(x, mask);
+}
+
+template <>
+inline __m512i hadd_impl<uint32_t>(__m512i x) noexcept
+{
+    const __m512i mask = _mm512_set1_epi32(0x0000003F);
+    x = hadd_impl<uint16_t>(x);
+    __m512i y = _mm512_bsrli_epi128(x, 2);
+    x = _mm512_add_epi32(x, y);
+    return _mm512_and_si512(x, mask);
+}
+
+template <>
+inline __m512i hadd_impl<uint64_t>(__m512i x) noexcept
+{
+    return _mm512_sad_epu8(x, _mm512_setzero_si512());
+}
+
+/* based on the paper `Faster Population Counts Using AVX2 Instructions` */
+template <typename T>
+native_simd<T> popcount_lookup_impl(const native_simd<T>& v) noexcept
+{
+    __m512i lookup = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+    const __m512i low_mask = _mm512_set1_epi8(0x0F);
+    __m512i lo = _mm512_and_si512(v, low_mask);
+    __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), low_mask);
+    __m512i popcnt1 = _mm512_shuffle_epi8(lookup, lo);
+    __m512i popcnt2 = _mm512_shuffle_epi8(lookup, hi);
+    __m512i total = _mm512_add_epi8(popcnt1, popcnt2);
+    return hadd_impl<T>(total);
+}
+
+template <typename T>
+native_simd<T> popcount_impl(const native_simd<T>& v) noexcept
+{
+    return popcount_lookup_impl(v);
+}
+
+/* The native popcount instructions are only used when they are enabled at compile time
+ * (e.g. -mavx512bitalg / -mavx512vpopcntdq or -march=icelake-client). The implementation selected
+ * at runtime only requires AVX512F + AVX512BW and always uses the lookup table. */
+#if defined(__AVX512BITALG__)
+template <>
+inline native_simd<uint8_t> popcount_impl(const native_simd<uint8_t>& v) noexcept
+{
+    return _mm512_popcnt_epi8(v);
+}
+
+template <>
+inline native_simd<uint16_t> popcount_impl(const native_simd<uint16_t>& v) noexcept
+{
+    return _mm512_popcnt_epi16(v);
+}
+#endif
+
+#if defined(__AVX512VPOPCNTDQ__)
+template <>
+inline native_simd<uint32_t> popcount_impl(const native_simd<uint32_t>& v) noexcept
+{
+    return _mm512_popcnt_epi32(v);
+}
+
+template <>
+inline native_simd<uint64_t> popcount_impl(const native_simd<uint64_t>& v) noexcept
+{
+    return _mm512_popcnt_epi64(v);
+}
+#endif
+
+template <typename T>
+std::array<T, native_simd<T>::size> popcount(const native_simd<T>& a) noexcept
+{
+    alignas(native_simd<T>::alignment) std::array<T, native_simd<T>::size> res;
+    popcount_impl(a).store(&res[0]);
+    return res;
+}
+
+// function andnot: a & ~ b
+template <typename T>
+native_simd<T> andnot(const native_simd<T>& a, const native_simd<T>& b)
+{
+    return _mm512_ternarylogic_epi64(a, b, b, 0x30);
+}
+
+// function blsi: a & -a
+template <typename T>
+native_simd<T> blsi(const native_simd<T>& a) noexcept
+{
+    return a & -a;
+}
+
+static inline native_simd<uint8_t> operator==(const native_simd<uint8_t>& a,
+                                              const native_simd<uint8_t>& b) noexcept
+{
+    return mask_to_vec8(_mm512_cmpeq_epi8_mask(a, b));
+}
+
+static inline native_simd<uint16_t> operator==(const native_simd<uint16_t>& a,
+                                               const native_simd<uint16_t>& b) noexcept
+{
+    return mask_to_vec16(_mm512_cmpeq_epi16_mask(a, b));
+}
+
+static inline native_simd<uint32_t> operator==(const native_simd<uint32_t>& a,
+                                               const native_simd<uint32_t>& b) noexcept
+{
+    return mask_to_vec32(_mm512_cmpeq_epi32_mask(a, b));
+}
+
+static inline native_simd<uint64_t> operator==(const native_simd<uint64_t>& a,
+                                               const native_simd<uint64_t>& b) noexcept
+{
+    return mask_to_vec64(_mm512_cmpeq_epi64_mask(a, b));
+}
+
+static inline native_simd<uint8_t> operator!=(const native_simd<uint8_t>& a,
+                                              const native_simd<uint8_t>& b) noexcept
+{
+    return mask_to_vec8(_mm512_cmpneq_epi8_mask(a, b));
+}
+
+static inline native_simd<uint16_t> operator!=(const native_simd<uint16_t>& a,
+                                               const native_simd<uint16_t>& b) noexcept
+{
+    return mask_to_vec16(_mm512_cmpneq_epi16_mask(a, b));
+}
+
+static inline native_simd<uint32_t> operator!=(const native_simd<uint32_t>& a,
+                                               const native_simd<uint32_t>& b) noexcept
+{
+    return mask_to_vec32(_mm512_cmpneq_epi32_mask(a, b));
+}
+
+static inline native_simd<uint64_t> operator!=(const native_simd<uint64_t>& a,
+                                               const native_simd<uint64_t>& b) noexcept
+{
+    return mask_to_vec64(_mm512_cmpneq_epi64_mask(a, b));
+}
+
+/* the shift intrinsics with immediate count require a constant when compiling without optimizations */
+static inline native_simd<uint8_t> operator<<(const native_simd<uint8_t>& a, int b) noexcept
+{
+    char mask = static_cast<char>(0xFF >> b);
+    __m512i am = _mm512_and_si512(a, _mm512_set1_epi8(mask));
+    return _mm512_sll_epi16(am, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint16_t> operator<<(const native_simd<uint16_t>& a, int b) noexcept
+{
+    return _mm512_sll_epi16(a, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint32_t> operator<<(const native_simd<uint32_t>& a, int b) noexcept
+{
+    return _mm512_maskz_sll_epi32(all_lanes32, a, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint64_t> operator<<(const native_simd<uint64_t>& a, int b) noexcept
+{
+    return _mm512_maskz_sll_epi64(all_lanes64, a, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint8_t> operator>>(const native_simd<uint8_t>& a, int b) noexcept
+{
+    char mask = static_cast<char>(0xFF << b);
+    __m512i am = _mm512_and_si512(a, _mm512_set1_epi8(mask));
+    return _mm512_srl_epi16(am, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint16_t> operator>>(const native_simd<uint16_t>& a, int b) noexcept
+{
+    return _mm512_srl_epi16(a, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint32_t> operator>>(const native_simd<uint32_t>& a, int b) noexcept
+{
+    return _mm512_maskz_srl_epi32(all_lanes32, a, _mm_cvtsi32_si128(b));
+}
+
+static inline native_simd<uint64_t> operator>>(const native_simd<uint64_t>& a, int b) noexcept
+{
+    return _mm512_maskz_srl_epi64(all_lanes64, a, _mm_cvtsi32_si128(b));
+}
+
+template <typename T>
+native_simd<T> operator&(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_and_si512(a, b);
+}
+
+template <typename T>
+native_simd<T> operator&=(native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    a = a & b;
+    return a;
+}
+
+template <typename T>
+native_simd<T> operator|(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_or_si512(a, b);
+}
+
+template <typename T>
+native_simd<T> operator|=(native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    a = a | b;
+    return a;
+}
+
+template <typename T>
+native_simd<T> operator^(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_xor_si512(a, b);
+}
+
+template <typename T>
+native_simd<T> operator^=(native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    a = a ^ b;
+    return a;
+}
+
+template <typename T>
+native_simd<T> operator~(const native_simd<T>& a) noexcept
+{
+    return _mm512_ternarylogic_epi32(a, a, a, 0x55);
+}
+
+static inline native_simd<uint8_t> operator>=(const native_simd<uint8_t>& a,
+                                              const native_simd<uint8_t>& b) noexcept
+{
+    return mask_to_vec8(_mm512_cmpge_epu8_mask(a, b));
+}
+
+static inline native_simd<uint16_t> operator>=(const native_simd<uint16_t>& a,
+                                               const native_simd<uint16_t>& b) noexcept
+{
+    return mask_to_vec16(_mm512_cmpge_epu16_mask(a, b));
+}
+
+static inline native_simd<uint32_t> operator>=(const native_simd<uint32_t>& a,
+                                               const native_simd<uint32_t>& b) noexcept
+{
+    return mask_to_vec32(_mm512_cmpge_epu32_mask(a, b));
+}
+
+static inline native_simd<uint64_t> operator>=(const native_simd<uint64_t>& a,
+                                               const native_simd<uint64_t>& b) noexcept
+{
+    return mask_to_vec64(_mm512_cmpge_epu64_mask(a, b));
+}
+
+template <typename T>
+static inline native_simd<T> operator<=(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return b >= a;
+}
+
+static inline native_simd<uint8_t> operator>(const native_simd<uint8_t>& a,
+                                             const native_simd<uint8_t>& b) noexcept
+{
+    return mask_to_vec8(_mm512_cmpgt_epu8_mask(a, b));
+}
+
+static inline native_simd<uint16_t> operator>(const native_simd<uint16_t>& a,
+                                              const native_simd<uint16_t>& b) noexcept
+{
+    return mask_to_vec16(_mm512_cmpgt_epu16_mask(a, b));
+}
+
+static inline native_simd<uint32_t> operator>(const native_simd<uint32_t>& a,
+                                              const native_simd<uint32_t>& b) noexcept
+{
+    return mask_to_vec32(_mm512_cmpgt_epu32_mask(a, b));
+}
+
+static inline native_simd<uint64_t> operator>(const native_simd<uint64_t>& a,
+                                              const native_simd<uint64_t>& b) noexcept
+{
+    return mask_to_vec64(_mm512_cmpgt_epu64_mask(a, b));
+}
+
+template <typename T>
+static inline native_simd<T> operator<(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return b > a;
+}
+
+template <typename T>
+static inline native_simd<T> max8(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_max_epu8(a, b);
+}
+
+template <typename T>
+static inline native_simd<T> max16(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_max_epu16(a, b);
+}
+
+template <typename T>
+static inline native_simd<T> max32(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_maskz_max_epu32(all_lanes32, a, b);
+}
+
+template <typename T>
+static inline native_simd<T> min8(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_min_epu8(a, b);
+}
+
+template <typename T>
+static inline native_simd<T> min16(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_min_epu16(a, b);
+}
+
+template <typename T>
+static inline native_simd<T> min32(const native_simd<T>& a, const native_simd<T>& b) noexcept
+{
+    return _mm512_maskz_min_epu32(all_lanes32, a, b);
+}
+
+/* there is no 8 bit variable shift. So the low and high byte of each 16 bit element are shifted separately */
+static inline native_simd<uint8_t> sllv(const native_simd<uint8_t>& a,
+                                        const native_simd<uint8_t>& count) noexcept
+{
+    const __m512i mask_lo = _mm512_set1_epi16(0x00FF);
+    __m512i lo = _mm512_sllv_epi16(_mm512_and_si512(a, mask_lo), _mm512_and_si512(count, mask_lo));
+    const __m512i mask_hi = _mm512_set1_epi16(static_cast<short>(0xFF00));
+    __m512i hi = _mm512_sllv_epi16(_mm512_and_si512(a, mask_hi), _mm512_srli_epi16(count, 8));
+    /* (lo & mask_lo) | hi */
+    return _mm512_ternarylogic_epi32(lo, mask_lo, hi, 0xEA);
+}
+
+static inline native_simd<uint16_t> sllv(const native_simd<uint16_t>& a,
+                                         const native_simd<uint16_t>& count) noexcept
+{
+    return _mm512_sllv_epi16(a, count);
+}
+
+static inline native_simd<uint32_t> sllv(const native_simd<uint32_t>& a,
+                                         const native_simd<uint32_t>& count) noexcept
+{
+    return _mm512_maskz_sllv_epi32(all_lanes32, a, count);
+}
+
+static inline native_simd<uint64_t> sllv(const native_simd<uint64_t>& a,
+                                         const native_simd<uint64_t>& count) noexcept
+{
+    return _mm512_maskz_sllv_epi64(all_lanes64, a, count);
+}
+
+} // namespace simd_avx512
+} // namespace detail
+} // namespace rapidfuzz
@@ -255,6 +255,14 @@ public:
         _mm_store_si128(reinterpret_cast<__m128i*>(p), xmm);
     }
 
+    /* bitmask of the size bytes of a and b, which differ */
+    static uint64_t mismatch_mask(const uint8_t* a, const uint8_t* b) noexcept
+    {
+        __m128i a_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        __m128i b_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        return ~static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a_, b_))) & 0xFFFF;
+    }
+
     native_simd operator+(const native_simd b) const noexcept
     {
         return _mm_add_epi8(xmm, b);
@@ -383,6 +391,13 @@ native_simd<T> andnot(const native_simd<T>& a, const native_simd<T>& b)
     return _mm_andnot_si128(b, a);
 }
 
+// function blsi: a & -a
+template <typename T>
+native_simd<T> blsi(const native_simd<T>& a) noexcept
+{
+    return a & -a;
+}
+
 static inline native_simd<uint8_t> operator==(const native_simd<uint8_t>& a,
                                               const native_simd<uint8_t>& b) noexcept
 {
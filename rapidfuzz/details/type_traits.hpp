@@ -5,7 +5,10 @@
 #include <rapidfuzz/details/types.hpp>
 
 #include <iterator>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace rapidfuzz {
 
@@ -15,6 +18,37 @@ auto inner_type(T const*) -> T;
 
 template <typename T>
 auto inner_type(T const&) -> typename T::value_type;
+
+/* partial backport of std::contiguous_iterator from C++20, which covers pointers and the
+ * iterators of std::vector and the std::basic_string typedefs
+ */
+template <typename Iter>
+struct is_contiguous_iterator {
+    using T = typename std::iterator_traits<Iter>::value_type;
+
+    template <typename String>
+    static constexpr bool is_string_iterator()
+    {
+        return std::is_same_v<Iter, typename String::iterator> ||
+               std::is_same_v<Iter, typename String::const_iterator>;
+    }
+
+    template <typename Vector>
+    static constexpr bool is_vector_iterator()
+    {
+        /* std::vector<bool> is not contiguous */
+        if constexpr (std::is_same_v<T, bool>)
+            return false;
+        else
+            return std::is_same_v<Iter, typename Vector::iterator> ||
+                   std::is_same_v<Iter, typename Vector::const_iterator>;
+    }
+
+    static constexpr bool value = std::is_pointer_v<Iter> || is_vector_iterator<std::vector<T>>() ||
+                                  is_string_iterator<std::string>() || is_string_iterator<std::wstring>() ||
+                                  is_string_iterator<std::u16string>() ||
+                                  is_string_iterator<std::u32string>();
+};
 } // namespace detail
 
 template <typename T>
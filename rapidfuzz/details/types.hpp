@@ -4,10 +4,15 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <stddef.h>
 #include <stdexcept>
+#include <stdint.h>
+#include <utility>
 #include <vector>
 
+#include <rapidfuzz/details/MemoryResource.hpp>
+
 namespace rapidfuzz {
 
 struct StringAffix {
@@ -159,28 +164,57 @@ void vector_remove_slice(Vec& vec, int start, int stop, int step)
     vec.shrink_to_fit();
 }
 
+using EditopsVector = std::vector<EditOp, ResourceAllocator<EditOp>>;
+
 } // namespace detail
 
 class Opcodes;
+class CompactEditops;
 
-class Editops : private std::vector<EditOp> {
+/**
+ * @brief list of edit operations
+ *
+ * @details
+ * The edit operations are allocated from the memory_resource passed to the constructor or from
+ * the global heap. The memory_resource moves together with the edit operations, while copies are
+ * allocated from the global heap.
+ */
+class Editops : private detail::EditopsVector {
 public:
-    using std::vector<EditOp>::size_type;
+    using detail::EditopsVector::size_type;
+    /* constructible from a memory_resource* */
+    using allocator_type = detail::ResourceAllocator<EditOp>;
 
     Editops() noexcept : src_len(0), dest_len(0)
     {}
 
-    Editops(size_type count, const EditOp& value) : std::vector<EditOp>(count, value), src_len(0), dest_len(0)
+    explicit Editops(const allocator_type& alloc) noexcept
+        : detail::EditopsVector(alloc), src_len(0), dest_len(0)
     {}
 
-    explicit Editops(size_type count) : std::vector<EditOp>(count), src_len(0), dest_len(0)
+    Editops(size_type count, const EditOp& value, const allocator_type& alloc = allocator_type())
+        : detail::EditopsVector(count, value, alloc), src_len(0), dest_len(0)
+    {}
+
+    explicit Editops(size_type count, const allocator_type& alloc = allocator_type())
+        : detail::EditopsVector(count, alloc), src_len(0), dest_len(0)
     {}
 
     Editops(const Editops& other)
-        : std::vector<EditOp>(other), src_len(other.src_len), dest_len(other.dest_len)
+        : detail::EditopsVector(other), src_len(other.src_len), dest_len(other.dest_len)
+    {}
+
+    /**
+     * @brief copies the edit operations into memory allocated using alloc
+     */
+    Editops(const Editops& other, const allocator_type& alloc)
+        : detail::EditopsVector(other.begin(), other.end(), alloc),
+          src_len(other.src_len),
+          dest_len(other.dest_len)
     {}
 
     Editops(const Opcodes& other);
+    Editops(const CompactEditops& other);
 
     Editops(Editops&& other) noexcept
     {
@@ -194,45 +228,45 @@ public:
     }
 
     /* Element access */
-    using std::vector<EditOp>::at;
-    using std::vector<EditOp>::operator[];
-    using std::vector<EditOp>::front;
-    using std::vector<EditOp>::back;
-    using std::vector<EditOp>::data;
+    using detail::EditopsVector::at;
+    using detail::EditopsVector::operator[];
+    using detail::EditopsVector::front;
+    using detail::EditopsVector::back;
+    using detail::EditopsVector::data;
 
     /* Iterators */
-    using std::vector<EditOp>::begin;
-    using std::vector<EditOp>::cbegin;
-    using std::vector<EditOp>::end;
-    using std::vector<EditOp>::cend;
-    using std::vector<EditOp>::rbegin;
-    using std::vector<EditOp>::crbegin;
-    using std::vector<EditOp>::rend;
-    using std::vector<EditOp>::crend;
+    using detail::EditopsVector::begin;
+    using detail::EditopsVector::cbegin;
+    using detail::EditopsVector::end;
+    using detail::EditopsVector::cend;
+    using detail::EditopsVector::rbegin;
+    using detail::EditopsVector::crbegin;
+    using detail::EditopsVector::rend;
+    using detail::EditopsVector::crend;
 
     /* Capacity */
-    using std::vector<EditOp>::empty;
-    using std::vector<EditOp>::size;
-    using std::vector<EditOp>::max_size;
-    using std::vector<EditOp>::reserve;
-    using std::vector<EditOp>::capacity;
-    using std::vector<EditOp>::shrink_to_fit;
+    using detail::EditopsVector::empty;
+    using detail::EditopsVector::size;
+    using detail::EditopsVector::max_size;
+    using detail::EditopsVector::reserve;
+    using detail::EditopsVector::capacity;
+    using detail::EditopsVector::shrink_to_fit;
 
     /* Modifiers */
-    using std::vector<EditOp>::clear;
-    using std::vector<EditOp>::insert;
-    using std::vector<EditOp>::emplace;
-    using std::vector<EditOp>::erase;
-    using std::vector<EditOp>::push_back;
-    using std::vector<EditOp>::emplace_back;
-    using std::vector<EditOp>::pop_back;
-    using std::vector<EditOp>::resize;
+    using detail::EditopsVector::clear;
+    using detail::EditopsVector::insert;
+    using detail::EditopsVector::emplace;
+    using detail::EditopsVector::erase;
+    using detail::EditopsVector::push_back;
+    using detail::EditopsVector::emplace_back;
+    using detail::EditopsVector::pop_back;
+    using detail::EditopsVector::resize;
 
     void swap(Editops& rhs) noexcept
     {
         std::swap(src_len, rhs.src_len);
         std::swap(dest_len, rhs.dest_len);
-        std::vector<EditOp>::swap(rhs);
+        detail::EditopsVector::swap(rhs);
     }
 
     Editops slice(int start, int stop, int step = 1) const
@@ -374,6 +408,7 @@ public:
     {}
 
     Opcodes(const Editops& other);
+    Opcodes(const CompactEditops& other);
 
     Opcodes(Opcodes&& other) noexcept
     {
@@ -499,71 +534,362 @@ inline void swap(Opcodes& lhs, Opcodes& rhs) noexcept(noexcept(lhs.swap(rhs)))
     lhs.swap(rhs);
 }
 
-inline Editops::Editops(const Opcodes& other)
+namespace detail {
+/* calls func for each edit operation described by the opcodes */
+template <typename Func>
+void opcodes_for_each_editop(const Opcodes& ops, Func&& func)
 {
-    src_len = other.get_src_len();
-    dest_len = other.get_dest_len();
-    for (const auto& op : other) {
+    for (const auto& op : ops) {
         switch (op.type) {
         case EditType::None: break;
 
         case EditType::Replace:
             for (size_t j = 0; j < op.src_end - op.src_begin; j++)
-                push_back({EditType::Replace, op.src_begin + j, op.dest_begin + j});
+                func(EditOp(EditType::Replace, op.src_begin + j, op.dest_begin + j));
             break;
 
         case EditType::Insert:
             for (size_t j = 0; j < op.dest_end - op.dest_begin; j++)
-                push_back({EditType::Insert, op.src_begin, op.dest_begin + j});
+                func(EditOp(EditType::Insert, op.src_begin, op.dest_begin + j));
             break;
 
         case EditType::Delete:
             for (size_t j = 0; j < op.src_end - op.src_begin; j++)
-                push_back({EditType::Delete, op.src_begin + j, op.dest_begin});
+                func(EditOp(EditType::Delete, op.src_begin + j, op.dest_begin));
             break;
         }
     }
 }
+} // namespace detail
+
+inline Editops::Editops(const Opcodes& other)
+{
+    src_len = other.get_src_len();
+    dest_len = other.get_dest_len();
+    detail::opcodes_for_each_editop(other, [this](const EditOp& op) { push_back(op); });
+}
+
+/**
+ * @brief converts edit operations passed in order into Opcode runs, which are passed to a
+ * callback as soon as they are complete, so the Opcodes are never stored.
+ *
+ * @details
+ * Consecutive edit operations of the same type are merged into one Opcode and the gaps between
+ * them are reported as EditType::None. finish() reports the last run and the equal suffix.
+ */
+template <typename Callback>
+class OpcodesWriter {
+public:
+    explicit OpcodesWriter(Callback callback)
+        : m_callback(std::forward<Callback>(callback)), m_run(), m_has_run(false), m_src_pos(0), m_dest_pos(0)
+    {}
+
+    void operator()(const EditOp& op)
+    {
+        if (m_has_run && op.type == m_run.type && op.src_pos == m_src_pos && op.dest_pos == m_dest_pos) {
+            advance(op.type);
+            return;
+        }
+
+        flush();
+        if (m_src_pos < op.src_pos || m_dest_pos < op.dest_pos) {
+            m_callback(Opcode(EditType::None, m_src_pos, op.src_pos, m_dest_pos, op.dest_pos));
+            m_src_pos = op.src_pos;
+            m_dest_pos = op.dest_pos;
+        }
+
+        m_run = Opcode(op.type, m_src_pos, m_src_pos, m_dest_pos, m_dest_pos);
+        m_has_run = true;
+        advance(op.type);
+    }
+
+    void finish(size_t src_len, size_t dest_len)
+    {
+        flush();
+        if (m_src_pos < src_len || m_dest_pos < dest_len)
+            m_callback(Opcode(EditType::None, m_src_pos, src_len, m_dest_pos, dest_len));
+
+        m_src_pos = src_len;
+        m_dest_pos = dest_len;
+    }
+
+private:
+    void advance(EditType type)
+    {
+        switch (type) {
+        case EditType::None: break;
+
+        case EditType::Replace:
+            m_src_pos++;
+            m_dest_pos++;
+            break;
+
+        case EditType::Insert: m_dest_pos++; break;
+
+        case EditType::Delete: m_src_pos++; break;
+        }
+    }
+
+    void flush()
+    {
+        if (!m_has_run) return;
+
+        m_run.src_end = m_src_pos;
+        m_run.dest_end = m_dest_pos;
+        m_callback(m_run);
+        m_has_run = false;
+    }
+
+    Callback m_callback;
+    Opcode m_run;
+    bool m_has_run;
+    size_t m_src_pos;
+    size_t m_dest_pos;
+};
 
 inline Opcodes::Opcodes(const Editops& other)
 {
     src_len = other.get_src_len();
     dest_len = other.get_dest_len();
-    size_t src_pos = 0;
-    size_t dest_pos = 0;
-    for (size_t i = 0; i < other.size();) {
-        if (src_pos < other[i].src_pos || dest_pos < other[i].dest_pos) {
-            push_back({EditType::None, src_pos, other[i].src_pos, dest_pos, other[i].dest_pos});
-            src_pos = other[i].src_pos;
-            dest_pos = other[i].dest_pos;
+
+    OpcodesWriter writer([this](const Opcode& op) { push_back(op); });
+    for (const auto& op : other)
+        writer(op);
+
+    writer.finish(src_len, dest_len);
+}
+
+/**
+ * @brief list of edit operations for strings with less than 2^32 characters
+ *
+ * @details
+ * The positions are stored as two 32 bit integers and the EditType is packed into 2 bits,
+ * so each edit operation requires a bit more than 8 bytes instead of the 24 bytes of EditOp.
+ * The edit operations are unpacked when accessing them, so they are returned by value.
+ * The edit operations of levenshtein_for_each_editop can be appended using push_back without
+ * creating an Editops first.
+ */
+class CompactEditops {
+public:
+    using size_type = size_t;
+
+    /* operator* returns the unpacked EditOp by value, so this is no forward iterator */
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = EditOp;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = EditOp;
+
+        const_iterator(const CompactEditops* ops, size_t pos) noexcept : m_ops(ops), m_pos(pos)
+        {}
+
+        EditOp operator*() const
+        {
+            return (*m_ops)[m_pos];
+        }
+
+        const_iterator& operator++() noexcept
+        {
+            ++m_pos;
+            return *this;
         }
 
-        size_t src_begin = src_pos;
-        size_t dest_begin = dest_pos;
-        EditType type = other[i].type;
-        do {
-            switch (type) {
-            case EditType::None: break;
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator tmp = *this;
+            ++m_pos;
+            return tmp;
+        }
 
-            case EditType::Replace:
-                src_pos++;
-                dest_pos++;
-                break;
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept
+        {
+            return a.m_pos == b.m_pos;
+        }
 
-            case EditType::Insert: dest_pos++; break;
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) noexcept
+        {
+            return a.m_pos != b.m_pos;
+        }
 
-            case EditType::Delete: src_pos++; break;
-            }
-            i++;
-        } while (i < other.size() && other[i].type == type && src_pos == other[i].src_pos &&
-                 dest_pos == other[i].dest_pos);
+    private:
+        const CompactEditops* m_ops;
+        size_t m_pos;
+    };
+
+    CompactEditops() noexcept : m_size(0), src_len(0), dest_len(0)
+    {}
+
+    explicit CompactEditops(const Editops& other) : m_size(0), src_len(0), dest_len(0)
+    {
+        set_src_len(other.get_src_len());
+        set_dest_len(other.get_dest_len());
+        reserve(other.size());
+        for (const auto& op : other)
+            push_back(op);
+    }
+
+    explicit CompactEditops(const Opcodes& other) : m_size(0), src_len(0), dest_len(0)
+    {
+        set_src_len(other.get_src_len());
+        set_dest_len(other.get_dest_len());
+        detail::opcodes_for_each_editop(other, [this](const EditOp& op) { push_back(op); });
+    }
+
+    EditOp operator[](size_t pos) const
+    {
+        auto type = static_cast<EditType>((m_types[pos / 4] >> (2 * (pos % 4))) & 3);
+        return EditOp(type, m_positions[pos].src_pos, m_positions[pos].dest_pos);
+    }
+
+    EditOp at(size_t pos) const
+    {
+        if (pos >= m_size) throw std::out_of_range("CompactEditops::at");
+        return (*this)[pos];
+    }
+
+    EditOp front() const
+    {
+        return (*this)[0];
+    }
+
+    EditOp back() const
+    {
+        return (*this)[m_size - 1];
+    }
 
-        push_back({type, src_begin, src_pos, dest_begin, dest_pos});
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, m_size);
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_size;
     }
 
-    if (src_pos < other.get_src_len() || dest_pos < other.get_dest_len()) {
-        push_back({EditType::None, src_pos, other.get_src_len(), dest_pos, other.get_dest_len()});
+    void reserve(size_t count)
+    {
+        m_positions.reserve(count);
+        m_types.reserve((count + 3) / 4);
+    }
+
+    void shrink_to_fit()
+    {
+        m_positions.shrink_to_fit();
+        m_types.shrink_to_fit();
+    }
+
+    void clear() noexcept
+    {
+        m_positions.clear();
+        m_types.clear();
+        m_size = 0;
+    }
+
+    void push_back(const EditOp& op)
+    {
+        if (op.src_pos > UINT32_MAX || op.dest_pos > UINT32_MAX)
+            throw std::invalid_argument("CompactEditops only supports positions below 2^32");
+
+        m_positions.push_back({static_cast<uint32_t>(op.src_pos), static_cast<uint32_t>(op.dest_pos)});
+        if (m_size % 4 == 0) m_types.push_back(0);
+        auto type = static_cast<unsigned>(op.type) << (2 * (m_size % 4));
+        m_types.back() = static_cast<uint8_t>(m_types.back() | type);
+        m_size++;
+    }
+
+    void swap(CompactEditops& rhs) noexcept
+    {
+        std::swap(m_size, rhs.m_size);
+        std::swap(src_len, rhs.src_len);
+        std::swap(dest_len, rhs.dest_len);
+        m_positions.swap(rhs.m_positions);
+        m_types.swap(rhs.m_types);
+    }
+
+    size_t get_src_len() const noexcept
+    {
+        return src_len;
+    }
+    void set_src_len(size_t len)
+    {
+        if (len > UINT32_MAX) throw std::invalid_argument("CompactEditops only supports lengths below 2^32");
+        src_len = static_cast<uint32_t>(len);
+    }
+    size_t get_dest_len() const noexcept
+    {
+        return dest_len;
     }
+    void set_dest_len(size_t len)
+    {
+        if (len > UINT32_MAX) throw std::invalid_argument("CompactEditops only supports lengths below 2^32");
+        dest_len = static_cast<uint32_t>(len);
+    }
+
+private:
+    struct Positions {
+        uint32_t src_pos;
+        uint32_t dest_pos;
+    };
+
+    std::vector<Positions> m_positions;
+    /* EditType of four edit operations per byte */
+    std::vector<uint8_t> m_types;
+    size_t m_size;
+    uint32_t src_len;
+    uint32_t dest_len;
+};
+
+inline bool operator==(const CompactEditops& lhs, const CompactEditops& rhs)
+{
+    if (lhs.get_src_len() != rhs.get_src_len() || lhs.get_dest_len() != rhs.get_dest_len()) return false;
+
+    if (lhs.size() != rhs.size()) return false;
+
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+inline bool operator!=(const CompactEditops& lhs, const CompactEditops& rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline void swap(CompactEditops& lhs, CompactEditops& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+inline Editops::Editops(const CompactEditops& other)
+{
+    src_len = other.get_src_len();
+    dest_len = other.get_dest_len();
+    reserve(other.size());
+    for (const auto& op : other)
+        push_back(op);
+}
+
+inline Opcodes::Opcodes(const CompactEditops& other)
+{
+    src_len = other.get_src_len();
+    dest_len = other.get_dest_len();
+
+    OpcodesWriter writer([this](const Opcode& op) { push_back(op); });
+    for (const auto& op : other)
+        writer(op);
+
+    writer.finish(src_len, dest_len);
 }
 
 template <typename T>
@@ -2,6 +2,7 @@
 /* Copyright © 2022-present Max Bachmann */
 
 #pragma once
+#include <rapidfuzz/details/instantiations.hpp>
 #include <rapidfuzz/distance/DamerauLevenshtein.hpp>
 #include <rapidfuzz/distance/Hamming.hpp>
 #include <rapidfuzz/distance/Indel.hpp>
@@ -9,15 +10,17 @@
 #include <rapidfuzz/distance/JaroWinkler.hpp>
 #include <rapidfuzz/distance/LCSseq.hpp>
 #include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/distance/MultiScorer.hpp>
 #include <rapidfuzz/distance/OSA.hpp>
 #include <rapidfuzz/distance/Postfix.hpp>
 #include <rapidfuzz/distance/Prefix.hpp>
 
 namespace rapidfuzz {
 
-template <typename CharT, typename InputIt1, typename InputIt2>
-std::basic_string<CharT> editops_apply(const Editops& ops, InputIt1 first1, InputIt1 last1, InputIt2 first2,
-                                       InputIt2 last2)
+namespace detail {
+template <typename CharT, typename EditopsT, typename InputIt1, typename InputIt2>
+std::basic_string<CharT> editops_apply_impl(const EditopsT& ops, InputIt1 first1, InputIt1 last1,
+                                            InputIt2 first2, InputIt2 last2)
 {
     auto len1 = static_cast<size_t>(std::distance(first1, last1));
     auto len2 = static_cast<size_t>(std::distance(first2, last2));
@@ -61,6 +64,22 @@ std::basic_string<CharT> editops_apply(const Editops& ops, InputIt1 first1, Inpu
     return res_str;
 }
 
+} // namespace detail
+
+template <typename CharT, typename InputIt1, typename InputIt2>
+std::basic_string<CharT> editops_apply(const Editops& ops, InputIt1 first1, InputIt1 last1, InputIt2 first2,
+                                       InputIt2 last2)
+{
+    return detail::editops_apply_impl<CharT>(ops, first1, last1, first2, last2);
+}
+
+template <typename CharT, typename InputIt1, typename InputIt2>
+std::basic_string<CharT> editops_apply(const CompactEditops& ops, InputIt1 first1, InputIt1 last1,
+                                       InputIt2 first2, InputIt2 last2)
+{
+    return detail::editops_apply_impl<CharT>(ops, first1, last1, first2, last2);
+}
+
 template <typename CharT, typename Sentence1, typename Sentence2>
 std::basic_string<CharT> editops_apply(const Editops& ops, const Sentence1& s1, const Sentence2& s2)
 {
@@ -68,6 +87,13 @@ std::basic_string<CharT> editops_apply(const Editops& ops, const Sentence1& s1,
                                 detail::to_end(s2));
 }
 
+template <typename CharT, typename Sentence1, typename Sentence2>
+std::basic_string<CharT> editops_apply(const CompactEditops& ops, const Sentence1& s1, const Sentence2& s2)
+{
+    return editops_apply<CharT>(ops, detail::to_begin(s1), detail::to_end(s1), detail::to_begin(s2),
+                                detail::to_end(s2));
+}
+
 template <typename CharT, typename InputIt1, typename InputIt2>
 std::basic_string<CharT> opcodes_apply(const Opcodes& ops, InputIt1 first1, InputIt1 last1, InputIt2 first2,
                                        InputIt2 last2)
@@ -1,8 +1,13 @@
 /* SPDX-License-Identifier: MIT */
 /* Copyright © 2022-present Max Bachmann */
 
+#pragma once
 #include <algorithm>
+#include <limits>
 #include <rapidfuzz/distance/DamerauLevenshtein_impl.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace rapidfuzz {
 /* the API will require a change when adding custom weights */
@@ -109,18 +114,184 @@ double damerau_levenshtein_normalized_similarity(const Sentence1& s1, const Sent
     return detail::DamerauLevenshtein::normalized_similarity(s1, s2, score_cutoff, score_cutoff);
 }
 
+#ifdef RAPIDFUZZ_SIMD
+/**
+ * @brief Compares a string with multiple strings of up to MaxLen characters
+ *
+ * @details
+ * There is no bit-parallel implementation of the Damerau-Levenshtein distance. So the simd
+ * implementation of the OSA distance is used to calculate `ceil(OSA / 2) <= DL <= OSA` for
+ * all strings at once. Strings with an OSA distance <= 2 have the same Damerau-Levenshtein
+ * distance and the remaining strings within 2 * score_cutoff are calculated one by one using
+ * the shared pattern match vector.
+ */
+template <int MaxLen>
+struct MultiDamerauLevenshtein : public detail::MultiDistanceBase<MultiDamerauLevenshtein<MaxLen>, size_t, 0,
+                                                                  std::numeric_limits<int64_t>::max()> {
+private:
+    friend detail::MultiDistanceBase<MultiDamerauLevenshtein<MaxLen>, size_t, 0,
+                                     std::numeric_limits<int64_t>::max()>;
+    friend detail::MultiNormalizedMetricBase<MultiDamerauLevenshtein<MaxLen>, size_t>;
+
+    constexpr static size_t get_vec_size()
+    {
+#    if defined(RAPIDFUZZ_AVX512)
+        using namespace detail::simd_avx512;
+#    elif defined(RAPIDFUZZ_AVX2)
+        using namespace detail::simd_avx2;
+#    else
+        using namespace detail::simd_sse2;
+#    endif
+        if constexpr (MaxLen <= 8)
+            return native_simd<uint8_t>::size;
+        else if constexpr (MaxLen <= 16)
+            return native_simd<uint16_t>::size;
+        else if constexpr (MaxLen <= 32)
+            return native_simd<uint32_t>::size;
+        else if constexpr (MaxLen <= 64)
+            return native_simd<uint64_t>::size;
+
+        static_assert(MaxLen == 8 || MaxLen == 16 || MaxLen == 32 || MaxLen == 64);
+    }
+
+    constexpr static size_t find_block_count(size_t count)
+    {
+        size_t vec_size = get_vec_size();
+        size_t simd_vec_count = detail::ceil_div(count, vec_size);
+        return detail::ceil_div(simd_vec_count * vec_size * MaxLen, 64);
+    }
+
+public:
+    MultiDamerauLevenshtein(size_t count) : input_count(count), PM(find_block_count(count) * 64)
+    {
+        str_lens.resize(result_count());
+    }
+
+    /**
+     * @brief get minimum size required for result vectors passed into
+     * - distance
+     * - similarity
+     * - normalized_distance
+     * - normalized_similarity
+     *
+     * @return minimum vector size
+     */
+    size_t result_count() const
+    {
+        size_t vec_size = get_vec_size();
+        size_t simd_vec_count = detail::ceil_div(input_count, vec_size);
+        return simd_vec_count * vec_size;
+    }
+
+    template <typename Sentence1>
+    void insert(const Sentence1& s1_)
+    {
+        insert(detail::to_begin(s1_), detail::to_end(s1_));
+    }
+
+    template <typename InputIt1>
+    void insert(InputIt1 first1, InputIt1 last1)
+    {
+        auto len = std::distance(first1, last1);
+        int block_pos = static_cast<int>((pos * MaxLen) % 64);
+        auto block = (pos * MaxLen) / 64;
+        assert(len <= MaxLen);
+
+        if (pos >= input_count) throw std::invalid_argument("out of bounds insert");
+
+        str_lens[pos] = static_cast<size_t>(len);
+        for (; first1 != last1; ++first1) {
+            PM.insert(block, *first1, block_pos);
+            block_pos++;
+        }
+        pos++;
+    }
+
+private:
+    template <typename InputIt2>
+    void _distance(size_t* scores, size_t score_count, const detail::Range<InputIt2>& s2,
+                   size_t score_cutoff = std::numeric_limits<size_t>::max()) const
+    {
+        if (score_count < result_count())
+            throw std::invalid_argument("scores has to have >= result_count() elements");
+
+        size_t osa_cutoff = detail::damerau_levenshtein_osa_cutoff(score_cutoff);
+        detail::Range scores_(scores, scores + score_count);
+        if constexpr (MaxLen == 8)
+            detail::osa_hyrroe2003_simd<uint8_t>(scores_, PM, str_lens, s2, osa_cutoff);
+        else if constexpr (MaxLen == 16)
+            detail::osa_hyrroe2003_simd<uint16_t>(scores_, PM, str_lens, s2, osa_cutoff);
+        else if constexpr (MaxLen == 32)
+            detail::osa_hyrroe2003_simd<uint32_t>(scores_, PM, str_lens, s2, osa_cutoff);
+        else if constexpr (MaxLen == 64)
+            detail::osa_hyrroe2003_simd<uint64_t>(scores_, PM, str_lens, s2, osa_cutoff);
+
+        for (size_t i = 0; i < result_count(); ++i) {
+            size_t dist = scores[i];
+            if (dist > osa_cutoff || detail::abs_diff(str_lens[i], s2.size()) > score_cutoff)
+                dist = score_cutoff + 1;
+            /* the OSA distance is exact for empty strings and distances <= 2 */
+            else if (dist > 2 && str_lens[i] != 0 && !s2.empty())
+                dist = detail::damerau_levenshtein_distance_zhao(PM, i * MaxLen, str_lens[i], s2,
+                                                                 std::min(score_cutoff, dist));
+
+            scores[i] = (dist <= score_cutoff) ? dist : score_cutoff + 1;
+        }
+    }
+
+    template <typename InputIt2>
+    size_t maximum(size_t s1_idx, const detail::Range<InputIt2>& s2) const
+    {
+        return std::max(str_lens[s1_idx], s2.size());
+    }
+
+    size_t get_input_count() const noexcept
+    {
+        return input_count;
+    }
+
+    size_t input_count;
+    size_t pos = 0;
+    detail::BlockPatternMatchVector PM;
+    std::vector<size_t> str_lens;
+};
+#endif
+
 template <typename CharT1>
 struct CachedDamerauLevenshtein : public detail::CachedDistanceBase<CachedDamerauLevenshtein<CharT1>, size_t,
                                                                     0, std::numeric_limits<int64_t>::max()> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedDamerauLevenshtein(const Sentence1& s1_)
-        : CachedDamerauLevenshtein(detail::to_begin(s1_), detail::to_end(s1_))
+    explicit CachedDamerauLevenshtein(const Sentence1& s1_, memory_resource* resource = nullptr)
+        : CachedDamerauLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), resource)
     {}
 
     template <typename InputIt1>
-    CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1) : s1(first1, last1)
+    CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+        : s1(first1, last1, resource), PM(detail::Range(first1, last1), resource)
     {}
 
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    CachedDamerauLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+        : CachedDamerauLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_))
+    {}
+
+    template <typename InputIt1>
+    CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+        : s1(first1, last1), PM(std::move(PM_))
+    {
+        detail::check_pattern_match_vector(PM, s1.size());
+    }
+
 private:
     friend detail::CachedDistanceBase<CachedDamerauLevenshtein<CharT1>, size_t, 0,
                                       std::numeric_limits<int64_t>::max()>;
@@ -136,17 +307,28 @@ private:
     size_t _distance(const detail::Range<InputIt2>& s2, size_t score_cutoff,
                      [[maybe_unused]] size_t score_hint) const
     {
-        return rapidfuzz::experimental::damerau_levenshtein_distance(s1, s2, score_cutoff);
+        return detail::damerau_levenshtein_distance(PM, detail::Range(s1), s2, score_cutoff);
     }
 
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
+    detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
-explicit CachedDamerauLevenshtein(const Sentence1& s1_) -> CachedDamerauLevenshtein<char_type<Sentence1>>;
+explicit CachedDamerauLevenshtein(const Sentence1& s1_, memory_resource* resource = nullptr)
+    -> CachedDamerauLevenshtein<char_type<Sentence1>>;
+
+template <typename InputIt1>
+CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+    -> CachedDamerauLevenshtein<iter_value_t<InputIt1>>;
+
+template <typename Sentence1>
+CachedDamerauLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+    -> CachedDamerauLevenshtein<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1) -> CachedDamerauLevenshtein<iter_value_t<InputIt1>>;
+CachedDamerauLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+    -> CachedDamerauLevenshtein<iter_value_t<InputIt1>>;
 
 } // namespace experimental
 } // namespace rapidfuzz
@@ -5,77 +5,91 @@
 #include <cstddef>
 #include <limits>
 #include <numeric>
-#include <rapidfuzz/details/GrowingHashmap.hpp>
 #include <rapidfuzz/details/Matrix.hpp>
+#include <rapidfuzz/details/PatternMatchVector.hpp>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/common.hpp>
 #include <rapidfuzz/details/distance.hpp>
+#include <rapidfuzz/details/intrinsics.hpp>
+#include <rapidfuzz/distance/OSA_impl.hpp>
 
 namespace rapidfuzz::detail {
 
-template <typename IntType>
-struct RowId {
-    IntType val = -1;
-    friend bool operator==(const RowId& lhs, const RowId& rhs)
-    {
-        return lhs.val == rhs.val;
-    }
-
-    friend bool operator!=(const RowId& lhs, const RowId& rhs)
-    {
-        return !(lhs == rhs);
-    }
-};
-
 /*
  * based on the paper
  * "Linear space string correction algorithm using the Damerau-Levenshtein distance"
  * from Chunchun Zhao and Sartaj Sahni
+ *
+ * The rows of the matrix are the characters of s2 and the columns the characters of s1. The
+ * characters are compared using the pattern match vector of s1 and the last row containing
+ * the character of each column is updated after each row from the same bitvectors, which
+ * avoids a hashmap lookup per cell. So s1 is only required as part of the pattern match vector.
+ *
+ * A cell (i, j) has a distance of at least |i - j|, so only the cells within a band of max around
+ * the diagonal are calculated. The cells next to the band are set to maxVal, so they are never
+ * used by a cell of the band. Since every alignment passes through each row, the calculation
+ * stops once all cells of a row are > max.
+ *
+ * @param PM pattern match vector, in which s1 starts at the position PM_offset
+ * @param len1 length of s1
  */
-template <typename IntType, typename InputIt1, typename InputIt2>
-size_t damerau_levenshtein_distance_zhao(const Range<InputIt1>& s1, const Range<InputIt2>& s2, size_t max)
+template <typename IntType, typename InputIt2>
+size_t damerau_levenshtein_distance_zhao_impl(const BlockPatternMatchVector& PM, size_t PM_offset,
+                                              size_t len1_, const Range<InputIt2>& s2, size_t max)
 {
-    // todo check types
-    IntType len1 = static_cast<IntType>(s1.size());
+    IntType len1 = static_cast<IntType>(len1_);
     IntType len2 = static_cast<IntType>(s2.size());
     IntType maxVal = static_cast<IntType>(std::max(len1, len2) + 1);
     assert(std::numeric_limits<IntType>::max() > maxVal);
+    IntType band = static_cast<IntType>(std::min<size_t>(max, static_cast<size_t>(maxVal)));
+    assert(len1_ != 0);
 
-    HybridGrowingHashmap<typename Range<InputIt1>::value_type, RowId<IntType>> last_row_id;
-    size_t size = s2.size() + 2;
+    /* last row containing the character of each column */
+    std::vector<IntType> last_row_id(len1_ + 1, IntType(-1));
+    /* one column in front of the matrix and two behind it for the cells next to the band */
+    size_t size = len1_ + 4;
     assume(size != 0);
     std::vector<IntType> FR_arr(size, maxVal);
     std::vector<IntType> R1_arr(size, maxVal);
-    std::vector<IntType> R_arr(size);
-    R_arr[0] = maxVal;
-    std::iota(R_arr.begin() + 1, R_arr.end(), IntType(0));
+    std::vector<IntType> R_arr(size, maxVal);
+    std::iota(R_arr.begin() + 1, R_arr.begin() + 1 + std::min<ptrdiff_t>(band, len1) + 1, IntType(0));
 
     IntType* R = &R_arr[1];
     IntType* R1 = &R1_arr[1];
     IntType* FR = &FR_arr[1];
 
-    auto iter_s1 = s1.begin();
-    for (IntType i = 1; i <= len1; i++) {
+    size_t first_pos = PM_offset;
+    size_t last_pos = PM_offset + len1_;
+
+    auto iter_s2 = s2.begin();
+    for (IntType i = 1; i <= len2; i++) {
         std::swap(R, R1);
+        IntType first_col = static_cast<IntType>(std::max<ptrdiff_t>(1, i - band));
+        IntType last_col = static_cast<IntType>(std::min<ptrdiff_t>(len1, i + band));
+
         IntType last_col_id = -1;
-        IntType last_i2l1 = R[0];
-        R[0] = i;
+        IntType last_i2l1 = R[first_col - 1];
+        R[first_col - 1] = (first_col == 1) ? i : maxVal;
         IntType T = maxVal;
-
-        auto iter_s2 = s2.begin();
-        for (IntType j = 1; j <= len2; j++) {
-            ptrdiff_t diag = R1[j - 1] + static_cast<IntType>(*iter_s1 != *iter_s2);
+        IntType row_min = maxVal;
+
+        /* position of column j in the pattern match vector */
+        size_t band_pos = first_pos + static_cast<size_t>(first_col) - 1;
+        uint64_t PM_j = PM.get(band_pos / 64, *iter_s2) >> (band_pos % 64);
+        for (IntType j = first_col; j <= last_col; j++) {
+            bool match = PM_j & 1;
+            ptrdiff_t diag = R1[j - 1] + static_cast<IntType>(!match);
             ptrdiff_t left = R[j - 1] + 1;
             ptrdiff_t up = R1[j] + 1;
             ptrdiff_t temp = std::min({diag, left, up});
 
-            if (*iter_s1 == *iter_s2) {
-                last_col_id = j;   // last occurence of s1_i
+            if (match) {
+                last_col_id = j;   // last occurence of s2_i
                 FR[j] = R1[j - 2]; // save H_k-1,j-2
                 T = last_i2l1;     // save H_i-2,l-1
             }
             else {
-                ptrdiff_t k = last_row_id.get(static_cast<uint64_t>(*iter_s2)).val;
+                ptrdiff_t k = last_row_id[static_cast<size_t>(j)];
                 ptrdiff_t l = last_col_id;
 
                 if ((j - l) == 1) {
@@ -89,14 +103,96 @@ size_t damerau_levenshtein_distance_zhao(const Range<InputIt1>& s1, const Range<
             }
 
             last_i2l1 = R[j];
-            R[j] = static_cast<IntType>(temp);
-            iter_s2++;
+            R[j] = static_cast<IntType>(std::min<ptrdiff_t>(temp, maxVal));
+            row_min = std::min(row_min, R[j]);
+
+            PM_j >>= 1;
+            if (++band_pos % 64 == 0 && j != last_col) PM_j = PM.get(band_pos / 64, *iter_s2);
         }
-        last_row_id[*iter_s1].val = i;
-        iter_s1++;
+
+        /* the cells next to the band still contain values of row i - 2 */
+        R[last_col + 1] = maxVal;
+        R[last_col + 2] = maxVal;
+        if (first_col == 1 && row_min > i) row_min = i;
+        if (static_cast<size_t>(row_min) > max) return max + 1;
+
+        /* columns containing s2_i. The columns in front of the band are never used again */
+        band_pos = first_pos + static_cast<size_t>(first_col) - 1;
+        for (size_t block = band_pos / 64; block * 64 < last_pos; ++block) {
+            uint64_t matches = PM.get(block, *iter_s2);
+            if (block == band_pos / 64) matches &= ~UINT64_C(0) << (band_pos % 64);
+            if ((block + 1) * 64 > last_pos) matches &= ~UINT64_C(0) >> (64 - last_pos % 64);
+
+            while (matches) {
+                size_t col = block * 64 + countr_zero(matches) - first_pos + 1;
+                last_row_id[col] = i;
+                /* FR was not saved for columns behind the band */
+                if (col > static_cast<size_t>(last_col)) FR[col] = maxVal;
+                matches = blsr(matches);
+            }
+        }
+
+        iter_s2++;
     }
 
-    size_t dist = static_cast<size_t>(R[s2.size()]);
+    size_t dist = static_cast<size_t>(R[len1_]);
+    return (dist <= max) ? dist : max + 1;
+}
+
+template <typename InputIt2>
+size_t damerau_levenshtein_distance_zhao(const BlockPatternMatchVector& PM, size_t PM_offset, size_t len1,
+                                         const Range<InputIt2>& s2, size_t max)
+{
+    size_t maxVal = std::max(len1, s2.size()) + 1;
+    if (std::numeric_limits<int16_t>::max() > maxVal)
+        return damerau_levenshtein_distance_zhao_impl<int16_t>(PM, PM_offset, len1, s2, max);
+    else if (std::numeric_limits<int32_t>::max() > maxVal)
+        return damerau_levenshtein_distance_zhao_impl<int32_t>(PM, PM_offset, len1, s2, max);
+    else
+        return damerau_levenshtein_distance_zhao_impl<int64_t>(PM, PM_offset, len1, s2, max);
+}
+
+/* the OSA distance is cut off at 2 * max, since ceil(OSA / 2) <= DamerauLevenshtein */
+static inline size_t damerau_levenshtein_osa_cutoff(size_t max)
+{
+    return (max < std::numeric_limits<size_t>::max() / 2) ? 2 * max : std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief Damerau-Levenshtein distance using the pattern match vector of s1
+ *
+ * @details
+ * Every OSA alignment is a valid Damerau-Levenshtein alignment and the Levenshtein distance
+ * is at most twice the Damerau-Levenshtein distance, so `ceil(OSA / 2) <= DL <= OSA`.
+ * In addition both distances are the same as long as the OSA distance is <= 2, since any
+ * single edit operation of Damerau-Levenshtein is an OSA operation as well. So the
+ * bit-parallel OSA implementation is used to reject strings and to calculate small distances.
+ * Only the remaining cases are calculated using the algorithm from Zhao and Sahni.
+ */
+template <typename InputIt1, typename InputIt2>
+size_t damerau_levenshtein_distance(const BlockPatternMatchVector& PM, Range<InputIt1> s1, Range<InputIt2> s2,
+                                    size_t max)
+{
+    size_t min_edits = abs_diff(s1.size(), s2.size());
+    if (min_edits > max) return max + 1;
+
+    if (s1.empty() || s2.empty()) {
+        size_t dist = std::max(s1.size(), s2.size());
+        return (dist <= max) ? dist : max + 1;
+    }
+
+    size_t osa_max = damerau_levenshtein_osa_cutoff(max);
+    size_t osa = (s1.size() < 64) ? osa_hyrroe2003(PM, s1, s2, osa_max)
+                                  : osa_hyrroe2003_block(PM, s1, s2, osa_max);
+    if (osa > osa_max) return max + 1;
+    if (osa <= 2) return (osa <= max) ? osa : max + 1;
+
+    /* common affix does not effect Levenshtein distance */
+    StringAffix affix = remove_common_affix(s1, s2);
+    size_t dist = std::max(s1.size(), s2.size());
+    /* the OSA distance is an upper bound, which allows using a smaller band */
+    if (!s1.empty() && !s2.empty())
+        dist = damerau_levenshtein_distance_zhao(PM, affix.prefix_len, s1.size(), s2, std::min(max, osa));
     return (dist <= max) ? dist : max + 1;
 }
 
@@ -108,14 +204,12 @@ size_t damerau_levenshtein_distance(Range<InputIt1> s1, Range<InputIt2> s2, size
 
     /* common affix does not effect Levenshtein distance */
     remove_common_affix(s1, s2);
+    if (s1.empty() || s2.empty()) {
+        size_t dist = std::max(s1.size(), s2.size());
+        return (dist <= max) ? dist : max + 1;
+    }
 
-    size_t maxVal = std::max(s1.size(), s2.size()) + 1;
-    if (std::numeric_limits<int16_t>::max() > maxVal)
-        return damerau_levenshtein_distance_zhao<int16_t>(s1, s2, max);
-    else if (std::numeric_limits<int32_t>::max() > maxVal)
-        return damerau_levenshtein_distance_zhao<int32_t>(s1, s2, max);
-    else
-        return damerau_levenshtein_distance_zhao<int64_t>(s1, s2, max);
+    return damerau_levenshtein_distance(BlockPatternMatchVector(s1), s1, s2, max);
 }
 
 class DamerauLevenshtein
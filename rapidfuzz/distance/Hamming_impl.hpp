@@ -2,12 +2,97 @@
 /* Copyright © 2021 Max Bachmann */
 
 #pragma once
+#include <rapidfuzz/details/PatternMatchVector.hpp>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/distance.hpp>
+#include <rapidfuzz/details/intrinsics.hpp>
+#include <rapidfuzz/details/simd.hpp>
+#include <rapidfuzz/details/type_traits.hpp>
 #include <stdexcept>
+#include <type_traits>
 
 namespace rapidfuzz::detail {
 
+/*
+ * The characters of contiguous strings with the same integral character type of 1 / 2 / 4 bytes
+ * are compared bytewise using simd
+ */
+template <typename InputIt1, typename InputIt2>
+constexpr bool hamming_simd_supported()
+{
+#ifdef RAPIDFUZZ_SIMD
+    using CharT1 = iter_value_t<InputIt1>;
+    using CharT2 = iter_value_t<InputIt2>;
+    if constexpr (!std::is_same_v<CharT1, CharT2> || !std::is_integral_v<CharT1> ||
+                  std::is_same_v<CharT1, bool>)
+        return false;
+    else
+        return (sizeof(CharT1) == 1 || sizeof(CharT1) == 2 || sizeof(CharT1) == 4) &&
+               is_contiguous_iterator<InputIt1>::value && is_contiguous_iterator<InputIt2>::value;
+#else
+    return false;
+#endif
+}
+
+#ifdef RAPIDFUZZ_SIMD
+/**
+ * @brief compares the characters of two contiguous strings in blocks of 64 bytes
+ *
+ * @details
+ * For each block func(pos, mask) is called, where the bit i * sizeof(CharT) of mask is set when
+ * the characters at pos + i differ. The comparison stops once func returns false.
+ *
+ * @return number of characters compared. The remaining characters do not fill a complete block
+ *   or the comparison was stopped
+ */
+template <template <typename> class native_simd, typename CharT, typename Func>
+size_t hamming_mismatch_blocks_impl(const CharT* s1, const CharT* s2, size_t len, Func&& func)
+{
+    static constexpr size_t vec_width = native_simd<uint8_t>::size;
+    static constexpr size_t block_len = 64 / sizeof(CharT);
+    /* lowest bit of each character */
+    static constexpr uint64_t char_mask = (sizeof(CharT) == 1)   ? ~UINT64_C(0)
+                                          : (sizeof(CharT) == 2) ? UINT64_C(0x5555555555555555)
+                                                                 : UINT64_C(0x1111111111111111);
+
+    size_t pos = 0;
+    while (pos + block_len <= len) {
+        const uint8_t* a = reinterpret_cast<const uint8_t*>(s1 + pos);
+        const uint8_t* b = reinterpret_cast<const uint8_t*>(s2 + pos);
+
+        uint64_t mask = 0;
+        unroll<size_t, 64 / vec_width>([&](auto i) {
+            mask |= native_simd<uint8_t>::mismatch_mask(a + i * vec_width, b + i * vec_width)
+                    << (i * vec_width);
+        });
+
+        /* a character differs when any of its bytes differs */
+        if constexpr (sizeof(CharT) >= 2) mask |= mask >> 1;
+        if constexpr (sizeof(CharT) == 4) mask |= mask >> 2;
+        mask &= char_mask;
+
+        bool proceed = func(pos, mask);
+        pos += block_len;
+        if (!proceed) break;
+    }
+
+    return pos;
+}
+
+template <typename CharT, typename Func, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+size_t hamming_mismatch_blocks(const CharT* s1, const CharT* s2, size_t len, Func&& func)
+{
+    /* avoid the dispatch for strings, which do not fill a block */
+    if (len < 64 / sizeof(CharT)) return 0;
+
+    size_t pos = 0;
+    simd_dispatch([&](auto simd) {
+        pos = hamming_mismatch_blocks_impl<decltype(simd)::template native_simd>(s1, s2, len, func);
+    });
+    return pos;
+}
+#endif
+
 class Hamming : public DistanceBase<Hamming, size_t, 0, std::numeric_limits<int64_t>::max(), bool> {
     friend DistanceBase<Hamming, size_t, 0, std::numeric_limits<int64_t>::max(), bool>;
     friend NormalizedMetricBase<Hamming, bool>;
@@ -28,13 +113,91 @@ class Hamming : public DistanceBase<Hamming, size_t, 0, std::numeric_limits<int6
         size_t dist = std::max(s1.size(), s2.size());
         auto iter_s1 = s1.begin();
         auto iter_s2 = s2.begin();
-        for (size_t i = 0; i < min_len; ++i)
+        size_t i = 0;
+
+#ifdef RAPIDFUZZ_SIMD
+        if constexpr (hamming_simd_supported<InputIt1, InputIt2>()) {
+            if (min_len != 0) {
+                size_t len_diff = dist - min_len;
+                size_t mismatches = 0;
+                i = hamming_mismatch_blocks(&*iter_s1, &*iter_s2, min_len, [&](size_t, uint64_t mask) {
+                    mismatches += popcount(mask);
+                    return len_diff + mismatches <= score_cutoff;
+                });
+                if (len_diff + mismatches > score_cutoff) return score_cutoff + 1;
+
+                dist -= i - mismatches;
+                iter_s1 += static_cast<ptrdiff_t>(i);
+                iter_s2 += static_cast<ptrdiff_t>(i);
+            }
+        }
+#endif
+
+        for (; i < min_len; ++i)
             dist -= bool(*(iter_s1++) == *(iter_s2++));
 
         return (dist <= score_cutoff) ? dist : score_cutoff + 1;
     }
 };
 
+#ifdef RAPIDFUZZ_SIMD
+/**
+ * @brief Hamming distance of multiple strings, which are stored in the lanes of the pattern match vector
+ *
+ * @details
+ * The character at position j of s1 matches s2 when bit j of its lane is set in the bitvector
+ * of s2[j]. So the matches of all lanes are collected by masking out bit j of the bitvectors
+ * of s2[j] and counted using a popcount per lane. Characters of s2 behind the lane width can
+ * not match, so only the first bits(VecType) characters of s2 are used.
+ */
+template <template <typename> class native_simd, typename VecType, typename InputIt>
+void hamming_simd_impl(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                       const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                       size_t score_cutoff) noexcept
+{
+    static constexpr size_t vec_width = native_simd<VecType>::size;
+    static constexpr size_t vecs = native_simd<uint64_t>::size;
+    assert(block.size() % vecs == 0);
+
+    size_t len2 = std::min(s2.size(), sizeof(VecType) * 8);
+    size_t result_index = 0;
+
+    for (size_t cur_vec = 0; cur_vec < block.size(); cur_vec += vecs) {
+        native_simd<VecType> matches(VecType(0));
+        native_simd<VecType> mask(VecType(1));
+
+        auto iter_s2 = s2.begin();
+        for (size_t j = 0; j < len2; ++j) {
+            alignas(native_simd<VecType>::alignment) std::array<uint64_t, vecs> stored;
+            unroll<int, vecs>([&](auto i) { stored[i] = block.get(cur_vec + i, *iter_s2); });
+
+            native_simd<VecType> PM_j(stored.data());
+            matches |= PM_j & mask;
+            mask = mask << 1;
+            ++iter_s2;
+        }
+
+        auto counts = popcount(matches);
+        unroll<int, vec_width>([&](auto i) {
+            size_t dist = std::max(s1_lengths[result_index], s2.size()) - counts[i];
+            scores[result_index] = (dist <= score_cutoff) ? dist : score_cutoff + 1;
+            result_index++;
+        });
+    }
+}
+
+template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void hamming_simd(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                  const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                  size_t score_cutoff) noexcept
+{
+    simd_dispatch([&](auto simd) {
+        hamming_simd_impl<decltype(simd)::template native_simd, VecType>(scores, block, s1_lengths, s2,
+                                                                         score_cutoff);
+    });
+}
+#endif
+
 template <typename InputIt1, typename InputIt2>
 Editops hamming_editops(const Range<InputIt1>& s1, const Range<InputIt2>& s2, bool pad, size_t)
 {
@@ -43,6 +206,22 @@ Editops hamming_editops(const Range<InputIt1>& s1, const Range<InputIt2>& s2, bo
     Editops ops;
     size_t min_len = std::min(s1.size(), s2.size());
     size_t i = 0;
+
+#ifdef RAPIDFUZZ_SIMD
+    if constexpr (hamming_simd_supported<InputIt1, InputIt2>()) {
+        if (min_len != 0) {
+            i = hamming_mismatch_blocks(&*s1.begin(), &*s2.begin(), min_len, [&](size_t pos, uint64_t mask) {
+                while (mask) {
+                    size_t index = pos + countr_zero(mask) / sizeof(iter_value_t<InputIt1>);
+                    ops.emplace_back(EditType::Replace, index, index);
+                    mask = blsr(mask);
+                }
+                return true;
+            });
+        }
+    }
+#endif
+
     for (; i < min_len; ++i)
         if (s1[i] != s2[i]) ops.emplace_back(EditType::Replace, i, i);
 
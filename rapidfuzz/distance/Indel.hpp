@@ -63,15 +63,16 @@ double indel_normalized_similarity(const Sentence1& s1, const Sentence2& s2, dou
 }
 
 template <typename InputIt1, typename InputIt2>
-Editops indel_editops(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+Editops indel_editops(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+                      memory_resource* resource = nullptr)
 {
-    return lcs_seq_editops(first1, last1, first2, last2);
+    return lcs_seq_editops(first1, last1, first2, last2, resource);
 }
 
 template <typename Sentence1, typename Sentence2>
-Editops indel_editops(const Sentence1& s1, const Sentence2& s2)
+Editops indel_editops(const Sentence1& s1, const Sentence2& s2, memory_resource* resource = nullptr)
 {
-    return lcs_seq_editops(s1, s2);
+    return lcs_seq_editops(s1, s2, resource);
 }
 
 #ifdef RAPIDFUZZ_SIMD
@@ -148,13 +149,34 @@ private:
 template <typename CharT1>
 struct CachedIndel
     : public detail::CachedDistanceBase<CachedIndel<CharT1>, size_t, 0, std::numeric_limits<int64_t>::max()> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedIndel(const Sentence1& s1_) : CachedIndel(detail::to_begin(s1_), detail::to_end(s1_))
+    explicit CachedIndel(const Sentence1& s1_, memory_resource* resource = nullptr)
+        : CachedIndel(detail::to_begin(s1_), detail::to_end(s1_), resource)
     {}
 
     template <typename InputIt1>
-    CachedIndel(InputIt1 first1, InputIt1 last1)
-        : s1_len(static_cast<size_t>(std::distance(first1, last1))), scorer(first1, last1)
+    CachedIndel(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+        : s1_len(static_cast<size_t>(std::distance(first1, last1))), scorer(first1, last1, resource)
+    {}
+
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    CachedIndel(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+        : CachedIndel(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_))
+    {}
+
+    template <typename InputIt1>
+    CachedIndel(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+        : s1_len(static_cast<size_t>(std::distance(first1, last1))), scorer(first1, last1, std::move(PM_))
     {}
 
 private:
@@ -183,9 +205,18 @@ private:
 };
 
 template <typename Sentence1>
-explicit CachedIndel(const Sentence1& s1_) -> CachedIndel<char_type<Sentence1>>;
+explicit CachedIndel(const Sentence1& s1_, memory_resource* resource = nullptr)
+    -> CachedIndel<char_type<Sentence1>>;
+
+template <typename InputIt1>
+CachedIndel(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+    -> CachedIndel<iter_value_t<InputIt1>>;
+
+template <typename Sentence1>
+CachedIndel(const Sentence1& s1_, detail::BlockPatternMatchVector PM_) -> CachedIndel<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedIndel(InputIt1 first1, InputIt1 last1) -> CachedIndel<iter_value_t<InputIt1>>;
+CachedIndel(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+    -> CachedIndel<iter_value_t<InputIt1>>;
 
 } // namespace rapidfuzz
@@ -79,7 +79,9 @@ private:
 
     constexpr static size_t get_vec_size()
     {
-#    ifdef RAPIDFUZZ_AVX2
+#    if defined(RAPIDFUZZ_AVX512)
+        return detail::simd_avx512::native_simd<VecType>::size;
+#    elif defined(RAPIDFUZZ_AVX2)
         return detail::simd_avx2::native_simd<VecType>::size;
 #    else
         return detail::simd_sse2::native_simd<VecType>::size;
@@ -88,7 +90,9 @@ private:
 
     constexpr static size_t get_vec_alignment()
     {
-#    ifdef RAPIDFUZZ_AVX2
+#    if defined(RAPIDFUZZ_AVX512)
+        return detail::simd_avx512::native_simd<VecType>::alignment;
+#    elif defined(RAPIDFUZZ_AVX2)
         return detail::simd_avx2::native_simd<VecType>::alignment;
 #    else
         return detail::simd_sse2::native_simd<VecType>::alignment;
@@ -193,12 +197,18 @@ private:
 
 template <typename CharT1>
 struct CachedJaro : public detail::CachedSimilarityBase<CachedJaro<CharT1>, double, 0, 1> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedJaro(const Sentence1& s1_) : CachedJaro(detail::to_begin(s1_), detail::to_end(s1_))
+    explicit CachedJaro(const Sentence1& s1_, memory_resource* resource = nullptr)
+        : CachedJaro(detail::to_begin(s1_), detail::to_end(s1_), resource)
     {}
 
     template <typename InputIt1>
-    CachedJaro(InputIt1 first1, InputIt1 last1) : s1(first1, last1), PM(detail::Range(first1, last1))
+    CachedJaro(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+        : s1(first1, last1, resource), PM(detail::Range(first1, last1), resource)
     {}
 
 private:
@@ -218,14 +228,16 @@ private:
         return detail::jaro_similarity(PM, detail::Range(s1), s2, score_cutoff);
     }
 
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
     detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
-explicit CachedJaro(const Sentence1& s1_) -> CachedJaro<char_type<Sentence1>>;
+explicit CachedJaro(const Sentence1& s1_, memory_resource* resource = nullptr)
+    -> CachedJaro<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedJaro(InputIt1 first1, InputIt1 last1) -> CachedJaro<iter_value_t<InputIt1>>;
+CachedJaro(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+    -> CachedJaro<iter_value_t<InputIt1>>;
 
 } // namespace rapidfuzz
@@ -167,14 +167,22 @@ private:
 
 template <typename CharT1>
 struct CachedJaroWinkler : public detail::CachedSimilarityBase<CachedJaroWinkler<CharT1>, double, 0, 1> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedJaroWinkler(const Sentence1& s1_, double _prefix_weight = 0.1)
-        : CachedJaroWinkler(detail::to_begin(s1_), detail::to_end(s1_), _prefix_weight)
+    explicit CachedJaroWinkler(const Sentence1& s1_, double _prefix_weight = 0.1,
+                               memory_resource* resource = nullptr)
+        : CachedJaroWinkler(detail::to_begin(s1_), detail::to_end(s1_), _prefix_weight, resource)
     {}
 
     template <typename InputIt1>
-    CachedJaroWinkler(InputIt1 first1, InputIt1 last1, double _prefix_weight = 0.1)
-        : prefix_weight(_prefix_weight), s1(first1, last1), PM(detail::Range(first1, last1))
+    CachedJaroWinkler(InputIt1 first1, InputIt1 last1, double _prefix_weight = 0.1,
+                      memory_resource* resource = nullptr)
+        : prefix_weight(_prefix_weight),
+          s1(first1, last1, resource),
+          PM(detail::Range(first1, last1), resource)
     {}
 
 private:
@@ -195,16 +203,16 @@ private:
     }
 
     double prefix_weight;
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
     detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
-explicit CachedJaroWinkler(const Sentence1& s1_, double _prefix_weight = 0.1)
-    -> CachedJaroWinkler<char_type<Sentence1>>;
+explicit CachedJaroWinkler(const Sentence1& s1_, double _prefix_weight = 0.1,
+                           memory_resource* resource = nullptr) -> CachedJaroWinkler<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedJaroWinkler(InputIt1 first1, InputIt1 last1, double _prefix_weight = 0.1)
-    -> CachedJaroWinkler<iter_value_t<InputIt1>>;
+CachedJaroWinkler(InputIt1 first1, InputIt1 last1, double _prefix_weight = 0.1,
+                  memory_resource* resource = nullptr) -> CachedJaroWinkler<iter_value_t<InputIt1>>;
 
 } // namespace rapidfuzz
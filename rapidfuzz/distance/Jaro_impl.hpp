@@ -353,7 +353,7 @@ static inline size_t jaro_bounds(Range<InputIt1>& P, Range<InputIt2>& T)
 }
 
 template <typename InputIt1, typename InputIt2>
-static inline double jaro_similarity(Range<InputIt1> P, Range<InputIt2> T, double score_cutoff)
+double jaro_similarity(Range<InputIt1> P, Range<InputIt2> T, double score_cutoff)
 {
     size_t P_len = P.size();
     size_t T_len = T.size();
@@ -401,8 +401,8 @@ static inline double jaro_similarity(Range<InputIt1> P, Range<InputIt2> T, doubl
 }
 
 template <typename InputIt1, typename InputIt2>
-static inline double jaro_similarity(const BlockPatternMatchVector& PM, Range<InputIt1> P, Range<InputIt2> T,
-                                     double score_cutoff)
+double jaro_similarity(const BlockPatternMatchVector& PM, Range<InputIt1> P, Range<InputIt2> T,
+                       double score_cutoff)
 {
     size_t P_len = P.size();
     size_t T_len = T.size();
@@ -456,15 +456,9 @@ struct JaroSimilaritySimdBounds {
     VecType boundMask;
 };
 
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+template <template <typename> class native_simd, typename VecType, typename InputIt>
 static inline auto jaro_similarity_prepare_bound_short_s2(const VecType* s1_lengths, Range<InputIt>& s2)
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
-
     [[maybe_unused]] static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vec_width = native_simd<VecType>::size;
     assert(s2.size() <= sizeof(VecType) * 8);
@@ -477,61 +471,57 @@ static inline auto jaro_similarity_prepare_bound_short_s2(const VecType* s1_leng
     for (size_t i = 0; i < vec_width; ++i)
         if (s1_lengths[i] > maxLen) maxLen = s1_lengths[i];
 
-#    ifdef RAPIDFUZZ_AVX2
-    native_simd<VecType> zero(VecType(0));
-    native_simd<VecType> one(1);
-
-    native_simd<VecType> s1_lengths_simd(reinterpret_cast<const uint64_t*>(s1_lengths));
-    native_simd<VecType> s2_length_simd(static_cast<VecType>(s2.size()));
-
-    // we always know that the number does not exceed 64, so we can operate on smaller vectors if this
-    // proves to be faster
-    native_simd<VecType> boundSizes = max8(s1_lengths_simd, s2_length_simd) >> 1; // divide by two
-    // todo there could be faster options since comparisions can be relatively expensive for some vector sizes
-    boundSizes -= (boundSizes > zero) & one;
-
-    // this can never overflow even when using larger vectors for shifting here, since in the worst case of
-    // 8bit vectors this shifts by (8/2-1)*2=6 bits todo << 1 performs unneeded masking here sllv is pretty
-    // expensive for 8 / 16 bit since it has to be emulated maybe there is a better solution
-    bounds.boundMaskSize = sllv(one, boundSizes << 1) - one;
-    bounds.boundMask = sllv(one, boundSizes + one) - one;
+    if constexpr (!std::is_same_v<native_simd<VecType>, simd_sse2::native_simd<VecType>>) {
+        native_simd<VecType> zero(VecType(0));
+        native_simd<VecType> one(1);
+
+        native_simd<VecType> s1_lengths_simd(reinterpret_cast<const uint64_t*>(s1_lengths));
+        native_simd<VecType> s2_length_simd(static_cast<VecType>(s2.size()));
+
+        // we always know that the number does not exceed 64, so we can operate on smaller vectors if this
+        // proves to be faster
+        native_simd<VecType> boundSizes = max8(s1_lengths_simd, s2_length_simd) >> 1; // divide by two
+        // todo there could be faster options since comparisions can be relatively expensive for some vector
+        // sizes
+        boundSizes -= (boundSizes > zero) & one;
+
+        // this can never overflow even when using larger vectors for shifting here, since in the worst case
+        // of 8bit vectors this shifts by (8/2-1)*2=6 bits todo << 1 performs unneeded masking here sllv is
+        // pretty expensive for 8 / 16 bit since it has to be emulated maybe there is a better solution
+        bounds.boundMaskSize = sllv(one, boundSizes << 1) - one;
+        bounds.boundMask = sllv(one, boundSizes + one) - one;
+
+        bounds.maxBound = (s2.size() > maxLen) ? s2.size() : maxLen;
+        bounds.maxBound /= 2;
+        if (bounds.maxBound > 0) bounds.maxBound--;
+    }
+    else {
+        alignas(alignment) std::array<VecType, vec_width> boundMaskSize_;
+        alignas(alignment) std::array<VecType, vec_width> boundMask_;
 
-    bounds.maxBound = (s2.size() > maxLen) ? s2.size() : maxLen;
-    bounds.maxBound /= 2;
-    if (bounds.maxBound > 0) bounds.maxBound--;
-#    else
-    alignas(alignment) std::array<VecType, vec_width> boundMaskSize_;
-    alignas(alignment) std::array<VecType, vec_width> boundMask_;
+        // todo try to find a simd implementation for sse2
+        for (size_t i = 0; i < vec_width; ++i) {
+            size_t Bound = jaro_bounds(s1_lengths[i], s2.size());
 
-    // todo try to find a simd implementation for sse2
-    for (size_t i = 0; i < vec_width; ++i) {
-        size_t Bound = jaro_bounds(s1_lengths[i], s2.size());
+            if (Bound > bounds.maxBound) bounds.maxBound = Bound;
 
-        if (Bound > bounds.maxBound) bounds.maxBound = Bound;
+            boundMaskSize_[i] = bit_mask_lsb<VecType>(2 * Bound);
+            boundMask_[i] = bit_mask_lsb<VecType>(Bound + 1);
+        }
 
-        boundMaskSize_[i] = bit_mask_lsb<VecType>(2 * Bound);
-        boundMask_[i] = bit_mask_lsb<VecType>(Bound + 1);
+        bounds.boundMaskSize = native_simd<VecType>(reinterpret_cast<uint64_t*>(boundMaskSize_.data()));
+        bounds.boundMask = native_simd<VecType>(reinterpret_cast<uint64_t*>(boundMask_.data()));
     }
 
-    bounds.boundMaskSize = native_simd<VecType>(reinterpret_cast<uint64_t*>(boundMaskSize_.data()));
-    bounds.boundMask = native_simd<VecType>(reinterpret_cast<uint64_t*>(boundMask_.data()));
-#    endif
-
     size_t lastRelevantChar = maxLen + bounds.maxBound;
     if (s2.size() > lastRelevantChar) s2.remove_suffix(s2.size() - lastRelevantChar);
 
     return bounds;
 }
 
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+template <template <typename> class native_simd, typename VecType, typename InputIt>
 static inline auto jaro_similarity_prepare_bound_long_s2(const VecType* s1_lengths, Range<InputIt>& s2)
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
-
     static constexpr size_t vec_width = native_simd<VecType>::size;
     assert(s2.size() > sizeof(VecType) * 8);
 
@@ -553,17 +543,11 @@ static inline auto jaro_similarity_prepare_bound_long_s2(const VecType* s1_lengt
     return bounds;
 }
 
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+template <template <typename> class native_simd, typename VecType, typename InputIt>
 static inline void
 jaro_similarity_simd_long_s2(Range<double*> scores, const detail::BlockPatternMatchVector& block,
                              VecType* s1_lengths, Range<InputIt> s2, double score_cutoff) noexcept
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
-
     static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vec_width = native_simd<VecType>::size;
     static constexpr size_t vecs = native_simd<uint64_t>::size;
@@ -597,7 +581,7 @@ jaro_similarity_simd_long_s2(Range<double*> scores, const detail::BlockPatternMa
 
     for (size_t cur_vec = 0; cur_vec < block.size(); cur_vec += vecs) {
         auto s2_cur = s2;
-        auto bounds = jaro_similarity_prepare_bound_long_s2(s1_lengths + result_index, s2_cur);
+        auto bounds = jaro_similarity_prepare_bound_long_s2<native_simd>(s1_lengths + result_index, s2_cur);
 
         native_simd<VecType> P_flag(VecType(0));
 
@@ -692,17 +676,11 @@ jaro_similarity_simd_long_s2(Range<double*> scores, const detail::BlockPatternMa
     }
 }
 
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+template <template <typename> class native_simd, typename VecType, typename InputIt>
 static inline void
 jaro_similarity_simd_short_s2(Range<double*> scores, const detail::BlockPatternMatchVector& block,
                               VecType* s1_lengths, Range<InputIt> s2, double score_cutoff) noexcept
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
-
     static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vec_width = native_simd<VecType>::size;
     static constexpr size_t vecs = native_simd<uint64_t>::size;
@@ -715,7 +693,7 @@ jaro_similarity_simd_short_s2(Range<double*> scores, const detail::BlockPatternM
 
     for (size_t cur_vec = 0; cur_vec < block.size(); cur_vec += vecs) {
         auto s2_cur = s2;
-        auto bounds = jaro_similarity_prepare_bound_short_s2(s1_lengths + result_index, s2_cur);
+        auto bounds = jaro_similarity_prepare_bound_short_s2<native_simd>(s1_lengths + result_index, s2_cur);
 
         native_simd<VecType> P_flag(VecType(0));
         native_simd<VecType> T_flag(VecType(0));
@@ -811,10 +789,14 @@ static inline void jaro_similarity_simd(Range<double*> scores, const detail::Blo
         return;
     }
 
-    if (s2.size() > sizeof(VecType) * 8)
-        return jaro_similarity_simd_long_s2(scores, block, s1_lengths, s2, score_cutoff);
-    else
-        return jaro_similarity_simd_short_s2(scores, block, s1_lengths, s2, score_cutoff);
+    simd_dispatch([&](auto simd) {
+        if (s2.size() > sizeof(VecType) * 8)
+            jaro_similarity_simd_long_s2<decltype(simd)::template native_simd>(scores, block, s1_lengths, s2,
+                                                                               score_cutoff);
+        else
+            jaro_similarity_simd_short_s2<decltype(simd)::template native_simd>(scores, block, s1_lengths, s2,
+                                                                                score_cutoff);
+    });
 }
 
 #endif /* RAPIDFUZZ_SIMD */
@@ -63,15 +63,16 @@ double lcs_seq_normalized_similarity(const Sentence1& s1, const Sentence2& s2, d
 }
 
 template <typename InputIt1, typename InputIt2>
-Editops lcs_seq_editops(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+Editops lcs_seq_editops(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+                        memory_resource* resource = nullptr)
 {
-    return detail::lcs_seq_editops(detail::Range(first1, last1), detail::Range(first2, last2));
+    return detail::lcs_seq_editops(detail::Range(first1, last1), detail::Range(first2, last2), resource);
 }
 
 template <typename Sentence1, typename Sentence2>
-Editops lcs_seq_editops(const Sentence1& s1, const Sentence2& s2)
+Editops lcs_seq_editops(const Sentence1& s1, const Sentence2& s2, memory_resource* resource = nullptr)
 {
-    return detail::lcs_seq_editops(detail::Range(s1), detail::Range(s2));
+    return detail::lcs_seq_editops(detail::Range(s1), detail::Range(s2), resource);
 }
 
 #ifdef RAPIDFUZZ_SIMD
@@ -85,7 +86,9 @@ private:
 
     constexpr static size_t get_vec_size()
     {
-#    ifdef RAPIDFUZZ_AVX2
+#    if defined(RAPIDFUZZ_AVX512)
+        using namespace detail::simd_avx512;
+#    elif defined(RAPIDFUZZ_AVX2)
         using namespace detail::simd_avx2;
 #    else
         using namespace detail::simd_sse2;
@@ -197,14 +200,38 @@ private:
 template <typename CharT1>
 struct CachedLCSseq
     : detail::CachedSimilarityBase<CachedLCSseq<CharT1>, size_t, 0, std::numeric_limits<int64_t>::max()> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedLCSseq(const Sentence1& s1_) : CachedLCSseq(detail::to_begin(s1_), detail::to_end(s1_))
+    explicit CachedLCSseq(const Sentence1& s1_, memory_resource* resource = nullptr)
+        : CachedLCSseq(detail::to_begin(s1_), detail::to_end(s1_), resource)
     {}
 
     template <typename InputIt1>
-    CachedLCSseq(InputIt1 first1, InputIt1 last1) : s1(first1, last1), PM(detail::Range(first1, last1))
+    CachedLCSseq(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+        : s1(first1, last1, resource), PM(detail::Range(first1, last1), resource)
+    {}
+
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    CachedLCSseq(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+        : CachedLCSseq(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_))
     {}
 
+    template <typename InputIt1>
+    CachedLCSseq(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+        : s1(first1, last1), PM(std::move(PM_))
+    {
+        detail::check_pattern_match_vector(PM, s1.size());
+    }
+
 private:
     friend detail::CachedSimilarityBase<CachedLCSseq<CharT1>, size_t, 0, std::numeric_limits<int64_t>::max()>;
     friend detail::CachedNormalizedMetricBase<CachedLCSseq<CharT1>>;
@@ -222,14 +249,23 @@ private:
         return detail::lcs_seq_similarity(PM, detail::Range(s1), s2, score_cutoff);
     }
 
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
     detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
-explicit CachedLCSseq(const Sentence1& s1_) -> CachedLCSseq<char_type<Sentence1>>;
+explicit CachedLCSseq(const Sentence1& s1_, memory_resource* resource = nullptr)
+    -> CachedLCSseq<char_type<Sentence1>>;
+
+template <typename InputIt1>
+CachedLCSseq(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+    -> CachedLCSseq<iter_value_t<InputIt1>>;
+
+template <typename Sentence1>
+CachedLCSseq(const Sentence1& s1_, detail::BlockPatternMatchVector PM_) -> CachedLCSseq<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedLCSseq(InputIt1 first1, InputIt1 last1) -> CachedLCSseq<iter_value_t<InputIt1>>;
+CachedLCSseq(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+    -> CachedLCSseq<iter_value_t<InputIt1>>;
 
 } // namespace rapidfuzz
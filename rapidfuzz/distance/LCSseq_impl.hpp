@@ -124,15 +124,10 @@ size_t lcs_seq_mbleven2018(const Range<InputIt1>& s1, const Range<InputIt2>& s2,
 }
 
 #ifdef RAPIDFUZZ_SIMD
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
-void lcs_simd(Range<size_t*> scores, const BlockPatternMatchVector& block, const Range<InputIt>& s2,
-              size_t score_cutoff) noexcept
+template <template <typename> class native_simd, typename VecType, typename InputIt>
+void lcs_simd_impl(Range<size_t*> scores, const BlockPatternMatchVector& block, const Range<InputIt>& s2,
+                   size_t score_cutoff) noexcept
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
     auto score_iter = scores.begin();
     static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vecs = native_simd<uint64_t>::size;
@@ -147,7 +142,7 @@ void lcs_simd(Range<size_t*> scores, const BlockPatternMatchVector& block, const
 
         for (const auto& ch : s2) {
             unroll<int, interleaveCount>([&](auto j) {
-                alignas(32) std::array<uint64_t, vecs> stored;
+                alignas(alignment) std::array<uint64_t, vecs> stored;
                 unroll<int, vecs>([&](auto i) { stored[i] = block.get(cur_vec + j * vecs + i, ch); });
 
                 native_simd<VecType> Matches(stored.data());
@@ -185,6 +180,15 @@ void lcs_simd(Range<size_t*> scores, const BlockPatternMatchVector& block, const
     }
 }
 
+template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void lcs_simd(Range<size_t*> scores, const BlockPatternMatchVector& block, const Range<InputIt>& s2,
+              size_t score_cutoff) noexcept
+{
+    simd_dispatch([&](auto simd) {
+        lcs_simd_impl<decltype(simd)::template native_simd, VecType>(scores, block, s2, score_cutoff);
+    });
+}
+
 #endif
 
 template <size_t N, bool RecordMatrix, typename PMV, typename InputIt1, typename InputIt2>
@@ -240,6 +244,12 @@ auto lcs_unroll(const PMV& block, const Range<InputIt1>&, const Range<InputIt2>&
  * from Heikki Hyyrö
  *
  * The paper refers to s1 as m and s2 as n
+ *
+ * The LCS increases by at most one per remaining character of s2. So the calculation stops once
+ * the LCS of the current row + the remaining characters of s2 is below score_cutoff. In the same
+ * way blocks in front of the band are no longer calculated, once the LCS up to the end of the
+ * block + the remaining characters of s2 is below score_cutoff, since no alignment passing
+ * through these blocks can reach the score_cutoff.
  */
 template <bool RecordMatrix, typename PMV, typename InputIt1, typename InputIt2>
 auto lcs_blockwise(const PMV& PM, const Range<InputIt1>& s1, const Range<InputIt2>& s2,
@@ -265,6 +275,8 @@ auto lcs_blockwise(const PMV& PM, const Range<InputIt1>& s1, const Range<InputIt
     /* first_block is the index of the first block in Ukkonen band. */
     size_t first_block = 0;
     size_t last_block = std::min(words, ceil_div(band_width_left + 1, word_size));
+    /* LCS up to the end of the blocks in front of the band, which are no longer updated */
+    size_t sim_before_band = 0;
 
     auto iter_s2 = s2.begin();
     for (size_t row = 0; row < s2.size(); ++row) {
@@ -284,10 +296,32 @@ auto lcs_blockwise(const PMV& PM, const Range<InputIt1>& s1, const Range<InputIt
             if constexpr (RecordMatrix) res.S[row][word - first_block] = S[word];
         }
 
-        if (row > band_width_right) first_block = (row - band_width_right) / word_size;
+        size_t band_start = (row > band_width_right) ? (row - band_width_right) / word_size : 0;
+        for (; first_block < band_start; ++first_block)
+            sim_before_band += popcount(~S[first_block]);
+
+        /* the bounds can only fail once less than score_cutoff characters of s2 are remaining.
+         * The popcount is comparably expensive, so they are only checked every word_size rows */
+        size_t remaining = s2.size() - row - 1;
+        if (remaining < score_cutoff && (row % word_size == word_size - 1 || remaining == 0)) {
+            size_t sim = sim_before_band;
+            for (size_t word = first_block; word < last_block; ++word)
+                sim += popcount(~S[word]);
+
+            if (sim + remaining < score_cutoff) {
+                res.sim = 0;
+                return res;
+            }
+
+            for (; first_block + 1 < last_block; ++first_block) {
+                size_t block_sim = sim_before_band + popcount(~S[first_block]);
+                if (block_sim + remaining >= score_cutoff) break;
+                sim_before_band = block_sim;
+            }
+        }
 
-        if (row + 1 + band_width_left <= s1.size())
-            last_block = ceil_div(row + 1 + band_width_left, word_size);
+        /* the next row reaches up to the bit row + 1 + band_width_left */
+        last_block = std::min(words, ceil_div(row + 2 + band_width_left, word_size));
 
         iter_s2++;
     }
@@ -410,12 +444,13 @@ size_t lcs_seq_similarity(Range<InputIt1> s1, Range<InputIt2> s2, size_t score_c
  */
 template <typename InputIt1, typename InputIt2>
 Editops recover_alignment(const Range<InputIt1>& s1, const Range<InputIt2>& s2,
-                          const LCSseqResult<true>& matrix, StringAffix affix)
+                          const LCSseqResult<true>& matrix, StringAffix affix,
+                          memory_resource* resource = nullptr)
 {
     size_t len1 = s1.size();
     size_t len2 = s2.size();
     size_t dist = len1 + len2 - 2 * matrix.sim;
-    Editops editops(dist);
+    Editops editops(dist, resource);
     editops.set_src_len(len1 + affix.prefix_len + affix.suffix_len);
     editops.set_dest_len(len2 + affix.prefix_len + affix.suffix_len);
 
@@ -500,12 +535,12 @@ LCSseqResult<true> lcs_matrix(const Range<InputIt1>& s1, const Range<InputIt2>&
 }
 
 template <typename InputIt1, typename InputIt2>
-Editops lcs_seq_editops(Range<InputIt1> s1, Range<InputIt2> s2)
+Editops lcs_seq_editops(Range<InputIt1> s1, Range<InputIt2> s2, memory_resource* resource = nullptr)
 {
     /* prefix and suffix are no-ops, which do not need to be added to the editops */
     StringAffix affix = remove_common_affix(s1, s2);
 
-    return recover_alignment(s1, s2, lcs_matrix(s1, s2), affix);
+    return recover_alignment(s1, s2, lcs_matrix(s1, s2), affix, resource);
 }
 
 class LCSseq : public SimilarityBase<LCSseq, size_t, 0, std::numeric_limits<int64_t>::max()> {
@@ -2,7 +2,11 @@
 /* Copyright © 2022-present Max Bachmann */
 
 #pragma once
+#include <cassert>
+#include <iterator>
 #include <limits>
+#include <stdexcept>
+#include <vector>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/distance/Levenshtein_impl.hpp>
 
@@ -276,22 +280,104 @@ double levenshtein_normalized_similarity(const Sentence1& s1, const Sentence2& s
  *   string to compare with s2 (for type info check Template parameters above)
  * @param s2
  *   string to compare with s1 (for type info check Template parameters above)
+ * @param score_hint
+ *   expected distance, which is used to speed up the calculation
+ * @param resource
+ *   memory_resource used to allocate the returned Editops or nullptr to use the global heap
+ * @param workers
+ *   number of threads used to calculate the two halves of each split of Hirschbergs algorithm.
+ *   0 uses `std::thread::hardware_concurrency()`
+ * @param memory_budget
+ *   size of the bit matrix in bytes up to which the alignment is calculated directly instead of
+ *   splitting the strings using Hirschbergs algorithm. Each worker allocates up to this size.
  *
  * @return Edit operations required to turn s1 into s2
  */
 template <typename InputIt1, typename InputIt2>
 Editops levenshtein_editops(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
-                            size_t score_hint = std::numeric_limits<size_t>::max())
+                            size_t score_hint = std::numeric_limits<size_t>::max(),
+                            memory_resource* resource = nullptr, size_t workers = 1,
+                            size_t memory_budget = detail::levenshtein_align_memory_budget)
 {
     return detail::levenshtein_editops(detail::Range(first1, last1), detail::Range(first2, last2),
-                                       score_hint);
+                                       score_hint, resource, workers, memory_budget);
 }
 
 template <typename Sentence1, typename Sentence2>
 Editops levenshtein_editops(const Sentence1& s1, const Sentence2& s2,
-                            size_t score_hint = std::numeric_limits<size_t>::max())
+                            size_t score_hint = std::numeric_limits<size_t>::max(),
+                            memory_resource* resource = nullptr, size_t workers = 1,
+                            size_t memory_budget = detail::levenshtein_align_memory_budget)
+{
+    return detail::levenshtein_editops(detail::Range(s1), detail::Range(s2), score_hint, resource, workers,
+                                       memory_budget);
+}
+
+/**
+ * @brief Pass the EditOp describing how to turn s1 into s2 to a callback in order.
+ *
+ * @details
+ * Unlike levenshtein_editops the edit operations are not stored. Hirschbergs algorithm splits
+ * the strings until the bit matrix of a part fits into memory_budget and only the edit operations
+ * of this part are stored while they are passed to the callback.
+ *
+ * @param s1
+ *   string to compare with s2 (for type info check Template parameters above)
+ * @param s2
+ *   string to compare with s1 (for type info check Template parameters above)
+ * @param callback
+ *   function called with each `const EditOp&`
+ * @param score_hint
+ *   expected distance, which is used to speed up the calculation
+ * @param memory_budget
+ *   size of the bit matrix in bytes up to which a part is aligned without splitting it
+ */
+template <typename InputIt1, typename InputIt2, typename Callback>
+void levenshtein_for_each_editop(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+                                 Callback&& callback, size_t score_hint = std::numeric_limits<size_t>::max(),
+                                 size_t memory_budget = detail::levenshtein_align_memory_budget)
 {
-    return detail::levenshtein_editops(detail::Range(s1), detail::Range(s2), score_hint);
+    detail::levenshtein_for_each_editop(detail::Range(first1, last1), detail::Range(first2, last2), callback,
+                                        score_hint, memory_budget);
+}
+
+template <typename Sentence1, typename Sentence2, typename Callback>
+void levenshtein_for_each_editop(const Sentence1& s1, const Sentence2& s2, Callback&& callback,
+                                 size_t score_hint = std::numeric_limits<size_t>::max(),
+                                 size_t memory_budget = detail::levenshtein_align_memory_budget)
+{
+    detail::levenshtein_for_each_editop(detail::Range(s1), detail::Range(s2), callback, score_hint,
+                                        memory_budget);
+}
+
+/**
+ * @brief Pass the Opcode describing how to turn s1 into s2 to a callback in order.
+ *
+ * @details
+ * Consecutive edit operations of the same type and equal parts are passed as a single Opcode,
+ * so long equal parts do not produce one entry per character. The Opcodes are not stored.
+ *
+ * @param callback
+ *   function called with each `const Opcode&`
+ *
+ * For the other parameters check levenshtein_for_each_editop
+ */
+template <typename InputIt1, typename InputIt2, typename Callback>
+void levenshtein_for_each_opcode(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
+                                 Callback&& callback, size_t score_hint = std::numeric_limits<size_t>::max(),
+                                 size_t memory_budget = detail::levenshtein_align_memory_budget)
+{
+    detail::levenshtein_for_each_opcode(detail::Range(first1, last1), detail::Range(first2, last2), callback,
+                                        score_hint, memory_budget);
+}
+
+template <typename Sentence1, typename Sentence2, typename Callback>
+void levenshtein_for_each_opcode(const Sentence1& s1, const Sentence2& s2, Callback&& callback,
+                                 size_t score_hint = std::numeric_limits<size_t>::max(),
+                                 size_t memory_budget = detail::levenshtein_align_memory_budget)
+{
+    detail::levenshtein_for_each_opcode(detail::Range(s1), detail::Range(s2), callback, score_hint,
+                                        memory_budget);
 }
 
 #ifdef RAPIDFUZZ_SIMD
@@ -306,7 +392,9 @@ private:
 
     constexpr static size_t get_vec_size()
     {
-#    ifdef RAPIDFUZZ_AVX2
+#    if defined(RAPIDFUZZ_AVX512)
+        using namespace detail::simd_avx512;
+#    elif defined(RAPIDFUZZ_AVX2)
         using namespace detail::simd_avx2;
 #    else
         using namespace detail::simd_sse2;
@@ -421,16 +509,42 @@ private:
 template <typename CharT1>
 struct CachedLevenshtein : public detail::CachedDistanceBase<CachedLevenshtein<CharT1>, size_t, 0,
                                                              std::numeric_limits<int64_t>::max()> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedLevenshtein(const Sentence1& s1_, LevenshteinWeightTable aWeights = {1, 1, 1})
-        : CachedLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), aWeights)
+    explicit CachedLevenshtein(const Sentence1& s1_, LevenshteinWeightTable aWeights = {1, 1, 1},
+                               memory_resource* resource = nullptr)
+        : CachedLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), aWeights, resource)
     {}
 
     template <typename InputIt1>
-    CachedLevenshtein(InputIt1 first1, InputIt1 last1, LevenshteinWeightTable aWeights = {1, 1, 1})
-        : s1(first1, last1), PM(detail::Range(first1, last1)), weights(aWeights)
+    CachedLevenshtein(InputIt1 first1, InputIt1 last1, LevenshteinWeightTable aWeights = {1, 1, 1},
+                      memory_resource* resource = nullptr)
+        : s1(first1, last1, resource), PM(detail::Range(first1, last1), resource), weights(aWeights)
     {}
 
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    CachedLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_,
+                      LevenshteinWeightTable aWeights = {1, 1, 1})
+        : CachedLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_), aWeights)
+    {}
+
+    template <typename InputIt1>
+    CachedLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_,
+                      LevenshteinWeightTable aWeights = {1, 1, 1})
+        : s1(first1, last1), PM(std::move(PM_)), weights(aWeights)
+    {
+        detail::check_pattern_match_vector(PM, s1.size());
+    }
+
 private:
     friend detail::CachedDistanceBase<CachedLevenshtein<CharT1>, size_t, 0,
                                       std::numeric_limits<int64_t>::max()>;
@@ -476,17 +590,392 @@ private:
         return detail::generalized_levenshtein_distance(detail::Range(s1), s2, weights, score_cutoff);
     }
 
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
     detail::BlockPatternMatchVector PM;
     LevenshteinWeightTable weights;
 };
 
 template <typename Sentence1>
-explicit CachedLevenshtein(const Sentence1& s1_, LevenshteinWeightTable aWeights = {1, 1, 1})
-    -> CachedLevenshtein<char_type<Sentence1>>;
+explicit CachedLevenshtein(const Sentence1& s1_, LevenshteinWeightTable aWeights = {1, 1, 1},
+                           memory_resource* resource = nullptr) -> CachedLevenshtein<char_type<Sentence1>>;
+
+template <typename Sentence1>
+CachedLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_,
+                  LevenshteinWeightTable aWeights = {1, 1, 1}) -> CachedLevenshtein<char_type<Sentence1>>;
+
+template <typename InputIt1>
+CachedLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_,
+                  LevenshteinWeightTable aWeights = {1, 1, 1}) -> CachedLevenshtein<iter_value_t<InputIt1>>;
+
+template <typename InputIt1>
+CachedLevenshtein(InputIt1 first1, InputIt1 last1, LevenshteinWeightTable aWeights = {1, 1, 1},
+                  memory_resource* resource = nullptr) -> CachedLevenshtein<iter_value_t<InputIt1>>;
+
+/**
+ * @brief match found by LevenshteinSearcher
+ */
+struct LevenshteinMatch {
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    size_t start; /**< start of the match in the text or npos when start positions are not recorded */
+    size_t end;   /**< end of the match in the text (exclusive) */
+    size_t dist;  /**< uniform Levenshtein distance between the pattern and the match */
+};
+
+inline bool operator==(const LevenshteinMatch& a, const LevenshteinMatch& b)
+{
+    return a.start == b.start && a.end == b.end && a.dist == b.dist;
+}
+
+inline bool operator!=(const LevenshteinMatch& a, const LevenshteinMatch& b)
+{
+    return !(a == b);
+}
+
+/**
+ * @brief Approximate search of a pattern in a text, which finds all end positions of substrings
+ * with a uniform Levenshtein distance <= max_dist to the pattern
+ *
+ * @details
+ * This uses the bit-parallel Levenshtein implementation with the first row of the matrix set to
+ * zero, so a match can start anywhere in the text. For patterns longer than 64 characters only the
+ * blocks, which can contain cells <= max_dist are calculated. The text can be passed in chunks,
+ * since the search continues where the last chunk ended. Each end position with a distance
+ * <= max_dist is reported, so a single occurrence usually leads to matches at multiple adjacent
+ * end positions.
+ *
+ * When start positions are recorded, the start of a match is found by searching the reversed
+ * pattern in the text preceding its end. Of all substrings ending there with the reported distance
+ * the shortest one is returned. The last `len(pattern) + max_dist` characters of the text are kept
+ * for this, so matches can span multiple chunks.
+ *
+ * @tparam CharT1 character type of the pattern
+ */
+template <typename CharT1>
+class LevenshteinSearcher {
+public:
+    template <typename Sentence1>
+    LevenshteinSearcher(const Sentence1& s1_, size_t max_dist, bool record_start_ = false)
+        : LevenshteinSearcher(detail::to_begin(s1_), detail::to_end(s1_), max_dist, record_start_)
+    {}
+
+    template <typename InputIt1>
+    LevenshteinSearcher(InputIt1 first1, InputIt1 last1, size_t max_dist, bool record_start_ = false)
+        : s1(first1, last1),
+          PM(detail::Range(s1)),
+          PM_reversed(record_start_ ? detail::BlockPatternMatchVector(detail::Range(s1.rbegin(), s1.rend()))
+                                   : detail::BlockPatternMatchVector(0)),
+          /* every end position is within a distance of len(pattern) */
+          max(std::min(max_dist, s1.size())),
+          record_start(record_start_),
+          stream(s1.size(), max)
+    {}
+
+    /**
+     * @brief continues the search with the next chunk of the text
+     *
+     * @param callback called with a LevenshteinMatch for each end position in the chunk
+     *   with a distance <= max_dist
+     */
+    template <typename InputIt2, typename Callback>
+    void feed(InputIt2 first2, InputIt2 last2, Callback&& callback)
+    {
+        _feed(stream, detail::Range(first2, last2), callback);
+    }
+
+    template <typename Sentence2, typename Callback>
+    void feed(const Sentence2& s2, Callback&& callback)
+    {
+        _feed(stream, detail::Range(s2), callback);
+    }
+
+    /**
+     * @brief restarts the search at position 0 of a new text
+     */
+    void reset()
+    {
+        stream = Stream(s1.size(), max);
+    }
+
+    /**
+     * @return number of characters of the text passed to feed since the last reset
+     */
+    size_t position() const noexcept
+    {
+        return stream.pos;
+    }
+
+    /**
+     * @brief searches a complete text. This does not affect the state of feed.
+     *
+     * @return matches sorted by their end position
+     */
+    template <typename InputIt2>
+    std::vector<LevenshteinMatch> search(InputIt2 first2, InputIt2 last2) const
+    {
+        return _search(detail::Range(first2, last2));
+    }
+
+    template <typename Sentence2>
+    std::vector<LevenshteinMatch> search(const Sentence2& s2) const
+    {
+        return _search(detail::Range(s2));
+    }
+
+private:
+    struct Stream {
+        Stream(size_t len1, size_t max_) : state(len1, max_), pos(0)
+        {}
+
+        detail::LevenshteinSearchState state;
+        size_t pos;
+        /* characters preceding pos, which are required to find the start of matches */
+        std::vector<uint64_t> history;
+    };
+
+    /* characters are stored the way they are looked up in the BlockPatternMatchVector */
+    template <typename CharT2>
+    static uint64_t history_key(CharT2 ch) noexcept
+    {
+        return static_cast<uint64_t>(ch);
+    }
+
+    static uint64_t history_key(char ch) noexcept
+    {
+        return static_cast<uint8_t>(ch);
+    }
+
+    template <typename InputIt2>
+    std::vector<LevenshteinMatch> _search(const detail::Range<InputIt2>& s2) const
+    {
+        std::vector<LevenshteinMatch> matches;
+        Stream text(s1.size(), max);
+        auto callback = [&](const LevenshteinMatch& match) { matches.push_back(match); };
+        _feed(text, s2, callback);
+        return matches;
+    }
+
+    template <typename InputIt2, typename Callback>
+    void _feed(Stream& text, const detail::Range<InputIt2>& s2, Callback& callback) const
+    {
+        size_t pos = text.pos;
+        text.pos += s2.size();
+
+        if (s1.empty()) {
+            for (size_t end = pos + 1; end <= text.pos; ++end)
+                callback(LevenshteinMatch{record_start ? end : LevenshteinMatch::npos, end, 0});
+            return;
+        }
+
+        if (!record_start) {
+            detail::levenshtein_search(PM, s1.size(), text.state, s2, max, [&](size_t i, size_t dist) {
+                callback(LevenshteinMatch{LevenshteinMatch::npos, pos + i + 1, dist});
+            });
+            return;
+        }
+
+        auto& history = text.history;
+        size_t history_start = pos - history.size();
+        for (const auto& ch : s2)
+            history.push_back(history_key(ch));
+
+        detail::levenshtein_search(PM, s1.size(), text.state, s2, max, [&](size_t i, size_t dist) {
+            size_t end = pos + i + 1;
+            auto first = history.rbegin() + static_cast<ptrdiff_t>(history_start + history.size() - end);
+            size_t len = detail::levenshtein_search_match_length(PM_reversed, s1.size(),
+                                                                 detail::Range(first, history.rend()), dist);
+            callback(LevenshteinMatch{end - len, end, dist});
+        });
+
+        /* a match has a length of at most len(pattern) + max */
+        size_t window = s1.size() + max;
+        if (history.size() > window)
+            history.erase(history.begin(), history.end() - static_cast<ptrdiff_t>(window));
+    }
+
+    std::vector<CharT1> s1;
+    detail::BlockPatternMatchVector PM;
+    detail::BlockPatternMatchVector PM_reversed;
+    size_t max;
+    bool record_start;
+    Stream stream;
+};
+
+template <typename Sentence1>
+LevenshteinSearcher(const Sentence1& s1_, size_t max_dist, bool record_start_ = false)
+    -> LevenshteinSearcher<char_type<Sentence1>>;
+
+template <typename InputIt1>
+LevenshteinSearcher(InputIt1 first1, InputIt1 last1, size_t max_dist, bool record_start_ = false)
+    -> LevenshteinSearcher<iter_value_t<InputIt1>>;
+
+/**
+ * @brief uniform Levenshtein distance between a fixed s1 and a s2, which is built character by
+ * character, e.g. the query of an autocomplete
+ *
+ * @details
+ * The bit rows of the bit-parallel implementation are stored for every prefix of s2. So appending
+ * a character only calculates a single column of `ceil(len(s1) / 64)` words and going back to
+ * a shorter prefix of s2 (e.g. on backspace) using pop_back / rollback does not require any
+ * calculation.
+ *
+ * @tparam CharT1 character type of s1
+ */
+template <typename CharT1>
+class IncrementalLevenshtein {
+public:
+    template <typename Sentence1>
+    explicit IncrementalLevenshtein(const Sentence1& s1_)
+        : IncrementalLevenshtein(detail::to_begin(s1_), detail::to_end(s1_))
+    {}
+
+    template <typename InputIt1>
+    IncrementalLevenshtein(InputIt1 first1, InputIt1 last1)
+        : IncrementalLevenshtein(first1, last1, detail::BlockPatternMatchVector(detail::Range(first1, last1)))
+    {}
+
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    IncrementalLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+        : IncrementalLevenshtein(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_))
+    {}
+
+    template <typename InputIt1>
+    IncrementalLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+        : len1(static_cast<size_t>(std::distance(first1, last1))), PM(std::move(PM_))
+    {
+        detail::check_pattern_match_vector(PM, len1);
+        clear();
+    }
+
+    /**
+     * @brief appends a character to s2
+     */
+    template <typename CharT2>
+    void push_back(CharT2 ch)
+    {
+        size_t words = PM.size();
+        size_t dist = dists.back();
+        if (words) {
+            columns.resize(columns.size() + words);
+            detail::LevenshteinRow* prev = columns.data() + columns.size() - 2 * words;
+            int delta = detail::levenshtein_hyrroe2003_column(PM, len1, prev, prev + words, ch);
+            dist = static_cast<size_t>(static_cast<ptrdiff_t>(dist) + delta);
+        }
+        else
+            dist++;
+
+        dists.push_back(dist);
+    }
+
+    template <typename InputIt2>
+    void append(InputIt2 first2, InputIt2 last2)
+    {
+        for (; first2 != last2; ++first2)
+            push_back(*first2);
+    }
+
+    template <typename Sentence2>
+    void append(const Sentence2& s2)
+    {
+        append(detail::to_begin(s2), detail::to_end(s2));
+    }
+
+    /**
+     * @brief removes the last character of s2. s2 must not be empty.
+     */
+    void pop_back()
+    {
+        assert(size() != 0);
+        rollback(size() - 1);
+    }
+
+    /**
+     * @brief returns to the state after the first len characters of s2 were appended
+     *
+     * @throws std::invalid_argument when len is larger than the current length of s2
+     */
+    void rollback(size_t len)
+    {
+        if (len > size()) throw std::invalid_argument("can not roll back to a longer s2");
+
+        dists.resize(len + 1);
+        columns.resize((len + 1) * PM.size());
+    }
+
+    /**
+     * @brief resets s2 to an empty string
+     */
+    void clear()
+    {
+        dists.assign(1, len1);
+        columns.assign(PM.size(), detail::LevenshteinRow());
+    }
+
+    /**
+     * @return length of s2, which can be passed to rollback to restore the current state
+     */
+    size_t size() const noexcept
+    {
+        return dists.size() - 1;
+    }
+
+    size_t distance(size_t score_cutoff = std::numeric_limits<size_t>::max()) const noexcept
+    {
+        size_t dist = dists.back();
+        return (dist <= score_cutoff) ? dist : score_cutoff + 1;
+    }
+
+    size_t similarity(size_t score_cutoff = 0) const noexcept
+    {
+        size_t maximum = std::max(len1, size());
+        if (score_cutoff > maximum) return 0;
+
+        size_t sim = maximum - dists.back();
+        return (sim >= score_cutoff) ? sim : 0;
+    }
+
+    double normalized_distance(double score_cutoff = 1.0) const noexcept
+    {
+        size_t maximum = std::max(len1, size());
+        double norm_dist =
+            (maximum != 0) ? static_cast<double>(dists.back()) / static_cast<double>(maximum) : 0.0;
+        return (norm_dist <= score_cutoff) ? norm_dist : 1.0;
+    }
+
+    double normalized_similarity(double score_cutoff = 0.0) const noexcept
+    {
+        double norm_dist = normalized_distance(detail::NormSim_to_NormDist(score_cutoff));
+        double norm_sim = 1.0 - norm_dist;
+        return (norm_sim >= score_cutoff) ? norm_sim : 0.0;
+    }
+
+private:
+    size_t len1;
+    detail::BlockPatternMatchVector PM;
+    /* bit rows of the Levenshtein matrix for each prefix of s2 */
+    std::vector<detail::LevenshteinRow> columns;
+    /* distance between s1 and each prefix of s2 */
+    std::vector<size_t> dists;
+};
+
+template <typename Sentence1>
+explicit IncrementalLevenshtein(const Sentence1& s1_) -> IncrementalLevenshtein<char_type<Sentence1>>;
+
+template <typename InputIt1>
+IncrementalLevenshtein(InputIt1 first1, InputIt1 last1) -> IncrementalLevenshtein<iter_value_t<InputIt1>>;
+
+template <typename Sentence1>
+IncrementalLevenshtein(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+    -> IncrementalLevenshtein<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedLevenshtein(InputIt1 first1, InputIt1 last1, LevenshteinWeightTable aWeights = {1, 1, 1})
-    -> CachedLevenshtein<iter_value_t<InputIt1>>;
+IncrementalLevenshtein(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+    -> IncrementalLevenshtein<iter_value_t<InputIt1>>;
 
 } // namespace rapidfuzz
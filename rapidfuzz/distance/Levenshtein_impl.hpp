@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <limits>
 #include <rapidfuzz/details/GrowingHashmap.hpp>
 #include <rapidfuzz/details/Matrix.hpp>
@@ -13,6 +14,7 @@
 #include <rapidfuzz/details/type_traits.hpp>
 #include <rapidfuzz/distance/Indel.hpp>
 #include <sys/types.h>
+#include <thread>
 
 namespace rapidfuzz::detail {
 
@@ -290,16 +292,11 @@ auto levenshtein_hyrroe2003(const PM_Vec& PM, const Range<InputIt1>& s1, const R
 }
 
 #ifdef RAPIDFUZZ_SIMD
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
-void levenshtein_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
-                                 const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
-                                 size_t score_cutoff) noexcept
+template <template <typename> class native_simd, typename VecType, typename InputIt>
+void levenshtein_hyrroe2003_simd_impl(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                                      const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                                      size_t score_cutoff) noexcept
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
     static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vec_width = native_simd<VecType>::size;
     static constexpr size_t vecs = native_simd<uint64_t>::size;
@@ -380,6 +377,17 @@ void levenshtein_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatte
         });
     }
 }
+
+template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void levenshtein_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                                 const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                                 size_t score_cutoff) noexcept
+{
+    simd_dispatch([&](auto simd) {
+        levenshtein_hyrroe2003_simd_impl<decltype(simd)::template native_simd, VecType>(
+            scores, block, s1_lengths, s2, score_cutoff);
+    });
+}
 #endif
 
 template <typename InputIt1, typename InputIt2>
@@ -734,9 +742,16 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
             }
         }
 
+        /* the distance of a cell in the block is at least the score of the block minus the
+         * number of positive vertical differences in the block */
+        auto block_min_in_band = [&](size_t word) {
+            if (scores[word] <= max) return true;
+            return scores[word] < max + word_size && scores[word] - max <= popcount(vecs[word].VP);
+        };
+
         for (; last_block >= first_block; --last_block) {
             /* in band if score <= k where score >= score_last - word_size + 1 */
-            bool in_band_cond1 = scores[last_block] < max + word_size;
+            bool in_band_cond1 = block_min_in_band(last_block);
 
             /* in band if row <= max - score - len2 + len1 + i
              * if the condition is met for the first cell in the block, it
@@ -750,12 +765,18 @@ auto levenshtein_hyrroe2003_block(const BlockPatternMatchVector& PM, const Range
             bool in_band_cond2 = static_cast<ptrdiff_t>(get_row_num(last_block)) <= cond;
 
             if (in_band_cond1 && in_band_cond2) break;
+
+            /* distance is larger than max, so band stops to exist */
+            if (last_block == first_block) {
+                res.dist = max + 1;
+                return res;
+            }
         }
 
         /* Band adjustment: first_block */
         for (; first_block <= last_block; ++first_block) {
             /* in band if score <= k where score >= score_last - word_size + 1 */
-            bool in_band_cond1 = scores[first_block] < max + word_size;
+            bool in_band_cond1 = block_min_in_band(first_block);
 
             /* in band if row >= score - max - len2 + len1 + i
              * if this condition is met for the last cell in the block, it
@@ -1044,6 +1065,225 @@ size_t levenshtein_distance(const Range<InputIt1>& s1, const Range<InputIt2>& s2
 
     return generalized_levenshtein_distance(s1, s2, weights, score_cutoff);
 }
+
+/**
+ * @brief calculates the column of the Levenshtein matrix after the character ch of s2 from the
+ * previous column. A column consists of one LevenshteinRow per block of s1 and prev may be the
+ * same as next.
+ *
+ * @return change of the distance in the last row
+ */
+template <typename CharT>
+int levenshtein_hyrroe2003_column(const BlockPatternMatchVector& PM, size_t len1, const LevenshteinRow* prev,
+                                  LevenshteinRow* next, CharT ch)
+{
+    size_t words = PM.size();
+    uint64_t Last = UINT64_C(1) << ((len1 - 1) % 64);
+
+    /* the first row is the distance to the empty prefix of s1 */
+    uint64_t HP_carry = 1;
+    uint64_t HN_carry = 0;
+
+    for (size_t word = 0; word < words; ++word) {
+        uint64_t PM_j = PM.get(word, ch);
+        uint64_t VN = prev[word].VN;
+        uint64_t VP = prev[word].VP;
+
+        uint64_t X = PM_j | HN_carry;
+        uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+        uint64_t HP = VN | ~(D0 | VP);
+        uint64_t HN = D0 & VP;
+
+        uint64_t HP_carry_temp = HP_carry;
+        uint64_t HN_carry_temp = HN_carry;
+        if (word < words - 1) {
+            HP_carry = HP >> 63;
+            HN_carry = HN >> 63;
+        }
+        else {
+            HP_carry = bool(HP & Last);
+            HN_carry = bool(HN & Last);
+        }
+
+        HP = (HP << 1) | HP_carry_temp;
+        HN = (HN << 1) | HN_carry_temp;
+
+        next[word].VP = HN | ~(D0 | HP);
+        next[word].VN = HP & D0;
+    }
+
+    return static_cast<int>(HP_carry) - static_cast<int>(HN_carry);
+}
+
+/**
+ * @brief state of the bit-parallel approximate search of s1 in a text
+ *
+ * @details
+ * The search uses the Levenshtein matrix of s1 and the text with the first row
+ * set to zero, so a match can start at any position of the text.
+ * Only the blocks up to last_block can contain cells <= max. All cells of the
+ * blocks below are known to be > max and are not calculated (Myers 1999).
+ */
+struct LevenshteinSearchState {
+    std::vector<LevenshteinRow> vecs;
+    /* distance in the last row of each block */
+    std::vector<size_t> scores;
+    size_t last_block;
+
+    LevenshteinSearchState(size_t len1, size_t max)
+        : vecs(ceil_div(len1, 64)), scores(vecs.size()), last_block(0)
+    {
+        for (size_t word = 0; word < scores.size(); ++word)
+            scores[word] = std::min((word + 1) * 64, len1);
+
+        /* row i of the first column has the distance i */
+        if (max != 0 && !vecs.empty()) last_block = std::min(vecs.size() - 1, (max - 1) / 64);
+    }
+};
+
+/**
+ * @brief continues the approximate search of s1 with the next characters of the text
+ *
+ * @param callback called with the index in s2 and the distance for each end position with a
+ *   distance <= max
+ */
+template <typename InputIt2, typename Callback>
+void levenshtein_search(const BlockPatternMatchVector& PM, size_t len1, LevenshteinSearchState& state,
+                        const Range<InputIt2>& s2, size_t max, Callback&& callback)
+{
+    assert(len1 != 0);
+    size_t words = state.vecs.size();
+    uint64_t Last = UINT64_C(1) << ((len1 - 1) % 64);
+
+    if (words == 1) {
+        uint64_t VP = state.vecs[0].VP;
+        uint64_t VN = state.vecs[0].VN;
+        size_t dist = state.scores[0];
+
+        auto iter_s2 = s2.begin();
+        for (size_t i = 0; iter_s2 != s2.end(); ++iter_s2, ++i) {
+            uint64_t X = PM.get(0, *iter_s2);
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            dist += bool(HP & Last);
+            dist -= bool(HN & Last);
+
+            /* no carry, since the first row is zero */
+            HP = HP << 1;
+            HN = HN << 1;
+
+            VP = HN | ~(D0 | HP);
+            VN = HP & D0;
+
+            if (dist <= max) callback(i, dist);
+        }
+
+        state.vecs[0] = LevenshteinRow(VP, VN);
+        state.scores[0] = dist;
+        return;
+    }
+
+    auto& vecs = state.vecs;
+    auto& scores = state.scores;
+    size_t last_block = state.last_block;
+
+    auto iter_s2 = s2.begin();
+    for (size_t i = 0; iter_s2 != s2.end(); ++iter_s2, ++i) {
+        uint64_t HP_carry = 0;
+        uint64_t HN_carry = 0;
+
+        auto advance_block = [&](size_t word) {
+            uint64_t PM_j = PM.get(word, *iter_s2);
+            uint64_t VN = vecs[word].VN;
+            uint64_t VP = vecs[word].VP;
+
+            uint64_t X = PM_j | HN_carry;
+            uint64_t D0 = (((X & VP) + VP) ^ VP) | X | VN;
+
+            uint64_t HP = VN | ~(D0 | VP);
+            uint64_t HN = D0 & VP;
+
+            uint64_t HP_carry_temp = HP_carry;
+            uint64_t HN_carry_temp = HN_carry;
+            if (word < words - 1) {
+                HP_carry = HP >> 63;
+                HN_carry = HN >> 63;
+            }
+            else {
+                HP_carry = bool(HP & Last);
+                HN_carry = bool(HN & Last);
+            }
+
+            HP = (HP << 1) | HP_carry_temp;
+            HN = (HN << 1) | HN_carry_temp;
+
+            vecs[word].VP = HN | ~(D0 | HP);
+            vecs[word].VN = HP & D0;
+
+            scores[word] += HP_carry;
+            scores[word] -= HN_carry;
+        };
+
+        size_t prev_score = scores[last_block];
+        for (size_t word = 0; word <= last_block; ++word)
+            advance_block(word);
+
+        /* The first cell of the next block can only be <= max, if the cell above it in the previous
+         * (diagonal) or the current column (vertical) is small enough. The cells of the next block
+         * were > max in the previous column, so they are initialized with increasing distances */
+        if (last_block + 1 < words && (prev_score <= max || scores[last_block] < max)) {
+            last_block++;
+            vecs[last_block] = LevenshteinRow();
+
+            size_t chars_in_block = (last_block + 1 == words) ? ((len1 - 1) % 64 + 1) : 64;
+            scores[last_block] = prev_score + chars_in_block;
+            advance_block(last_block);
+        }
+        else {
+            /* the distances of adjacent rows differ by at most 1, so all cells of the block are > max */
+            while (last_block > 0 && scores[last_block] > max && scores[last_block] - max >= 64)
+                last_block--;
+        }
+
+        if (last_block + 1 == words && scores[last_block] <= max) callback(i, scores[last_block]);
+    }
+
+    state.last_block = last_block;
+}
+
+/**
+ * @brief length of the shortest prefix of s2 with the Levenshtein distance dist to s1.
+ *
+ * @details
+ * This is used to find the start of a match of the approximate search by passing the
+ * reversed pattern and the reversed text preceding the end of the match. dist has to be
+ * the minimum distance of s1 to any prefix of s2.
+ *
+ * @param PM pattern match vector of s1
+ */
+template <typename InputIt2>
+size_t levenshtein_search_match_length(const BlockPatternMatchVector& PM, size_t len1,
+                                       const Range<InputIt2>& s2, size_t dist)
+{
+    if (len1 <= dist) return 0;
+
+    std::vector<LevenshteinRow> vecs(PM.size());
+    size_t score = len1;
+
+    auto iter_s2 = s2.begin();
+    for (size_t i = 0; iter_s2 != s2.end(); ++iter_s2, ++i) {
+        int delta = levenshtein_hyrroe2003_column(PM, len1, vecs.data(), vecs.data(), *iter_s2);
+        score = static_cast<size_t>(static_cast<ptrdiff_t>(score) + delta);
+        if (score <= dist) return i + 1;
+    }
+
+    return s2.size();
+}
+
 struct HirschbergPos {
     size_t left_score;
     size_t right_score;
@@ -1051,9 +1291,44 @@ struct HirschbergPos {
     size_t s2_mid;
 };
 
+/*
+ * Runs func1 and func2. When parallel is true func1 runs in a new thread while func2 runs in the
+ * calling thread. An exception thrown by either of them is rethrown after both finished.
+ */
+template <typename Func1, typename Func2>
+void invoke_parallel(bool parallel, Func1&& func1, Func2&& func2)
+{
+    if (!parallel) {
+        func1();
+        func2();
+        return;
+    }
+
+    std::exception_ptr exception;
+    std::thread thread([&]() {
+        try {
+            func1();
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+    });
+
+    try {
+        func2();
+    }
+    catch (...) {
+        thread.join();
+        throw;
+    }
+
+    thread.join();
+    if (exception) std::rethrow_exception(exception);
+}
+
 template <typename InputIt1, typename InputIt2>
 HirschbergPos find_hirschberg_pos(const Range<InputIt1>& s1, const Range<InputIt2>& s2,
-                                  size_t max = std::numeric_limits<size_t>::max())
+                                  size_t max = std::numeric_limits<size_t>::max(), size_t workers = 1)
 {
     HirschbergPos hpos = {};
     size_t left_size = s2.size() / 2;
@@ -1065,30 +1340,32 @@ HirschbergPos find_hirschberg_pos(const Range<InputIt1>& s1, const Range<InputIt
     size_t right_last_pos = 0;
     std::vector<size_t> right_scores;
 
-    {
-        auto right_row = levenshtein_row(s1.reversed(), s2.reversed(), max, right_size - 1);
-        if (right_row.dist > max) return find_hirschberg_pos(s1, s2, max * 2);
+    /* the rows in the middle of s2 are calculated from both ends at the same time */
+    LevenshteinResult<false, true> left_row;
+    LevenshteinResult<false, true> right_row;
+    invoke_parallel(
+        workers > 1,
+        [&]() { right_row = levenshtein_row(s1.reversed(), s2.reversed(), max, right_size - 1); },
+        [&]() { left_row = levenshtein_row(s1, s2, max, left_size - 1); });
 
-        right_first_pos = right_row.first_block * 64;
-        right_last_pos = std::min(s1_len, right_row.last_block * 64 + 64);
+    if (right_row.dist > max || left_row.dist > max) return find_hirschberg_pos(s1, s2, max * 2, workers);
 
-        right_scores.resize(right_last_pos - right_first_pos + 1, 0);
-        assume(right_scores.size() != 0);
-        right_scores[0] = right_row.prev_score;
+    right_first_pos = right_row.first_block * 64;
+    right_last_pos = std::min(s1_len, right_row.last_block * 64 + 64);
 
-        for (size_t i = right_first_pos; i < right_last_pos; ++i) {
-            size_t col_pos = i % 64;
-            size_t col_word = i / 64;
-            uint64_t col_mask = UINT64_C(1) << col_pos;
+    right_scores.resize(right_last_pos - right_first_pos + 1, 0);
+    assume(right_scores.size() != 0);
+    right_scores[0] = right_row.prev_score;
 
-            right_scores[i - right_first_pos + 1] = right_scores[i - right_first_pos];
-            right_scores[i - right_first_pos + 1] -= bool(right_row.vecs[col_word].VN & col_mask);
-            right_scores[i - right_first_pos + 1] += bool(right_row.vecs[col_word].VP & col_mask);
-        }
-    }
+    for (size_t i = right_first_pos; i < right_last_pos; ++i) {
+        size_t col_pos = i % 64;
+        size_t col_word = i / 64;
+        uint64_t col_mask = UINT64_C(1) << col_pos;
 
-    auto left_row = levenshtein_row(s1, s2, max, left_size - 1);
-    if (left_row.dist > max) return find_hirschberg_pos(s1, s2, max * 2);
+        right_scores[i - right_first_pos + 1] = right_scores[i - right_first_pos];
+        right_scores[i - right_first_pos + 1] -= bool(right_row.vecs[col_word].VN & col_mask);
+        right_scores[i - right_first_pos + 1] += bool(right_row.vecs[col_word].VP & col_mask);
+    }
 
     auto left_first_pos = left_row.first_block * 64;
     auto left_last_pos = std::min(s1_len, left_row.last_block * 64 + 64);
@@ -1119,19 +1396,25 @@ HirschbergPos find_hirschberg_pos(const Range<InputIt1>& s1, const Range<InputIt
     assert(hpos.right_score >= 0);
 
     if (hpos.left_score + hpos.right_score > max)
-        return find_hirschberg_pos(s1, s2, max * 2);
+        return find_hirschberg_pos(s1, s2, max * 2, workers);
     else {
         assert(levenshtein_distance(s1, s2) == hpos.left_score + hpos.right_score);
         return hpos;
     }
 }
 
+/* size of the bit matrices in bytes up to which levenshtein_editops does not split the strings */
+constexpr size_t levenshtein_align_memory_budget = 1024 * 1024;
+
+/*
+ * Removes the common prefix and suffix, which are no-ops that do not need to be added to the editops,
+ * and limits max to the remaining strings. Returns whether the bit matrix of the remaining strings
+ * fits into memory_budget, so they are aligned directly instead of being split further.
+ */
 template <typename InputIt1, typename InputIt2>
-void levenshtein_align_hirschberg(Editops& editops, Range<InputIt1> s1, Range<InputIt2> s2,
-                                  size_t src_pos = 0, size_t dest_pos = 0, size_t editop_pos = 0,
-                                  size_t max = std::numeric_limits<size_t>::max())
+bool levenshtein_align_prepare(Range<InputIt1>& s1, Range<InputIt2>& s2, size_t& src_pos, size_t& dest_pos,
+                               size_t& max, size_t memory_budget)
 {
-    /* prefix and suffix are no-ops, which do not need to be added to the editops */
     StringAffix affix = remove_common_affix(s1, s2);
     src_pos += affix.prefix_len;
     dest_pos += affix.prefix_len;
@@ -1140,20 +1423,67 @@ void levenshtein_align_hirschberg(Editops& editops, Range<InputIt1> s1, Range<In
     size_t full_band = std::min(s1.size(), 2 * max + 1);
 
     size_t matrix_size = 2 * full_band * s2.size() / 8;
-    if (matrix_size < 1024 * 1024 || s1.size() < 65 || s2.size() < 10) {
+    return matrix_size < memory_budget || s1.size() < 65 || s2.size() < 10;
+}
+
+/*
+ * Hirschbergs algorithm splits the strings until the bit matrix of the remaining parts fits into
+ * memory_budget. The two halves of a split write to separate ranges of editops, so they are
+ * calculated in parallel while more than one worker is available.
+ */
+template <typename InputIt1, typename InputIt2>
+void levenshtein_align_hirschberg(Editops& editops, Range<InputIt1> s1, Range<InputIt2> s2,
+                                  size_t src_pos = 0, size_t dest_pos = 0, size_t editop_pos = 0,
+                                  size_t max = std::numeric_limits<size_t>::max(), size_t workers = 1,
+                                  size_t memory_budget = levenshtein_align_memory_budget)
+{
+    if (levenshtein_align_prepare(s1, s2, src_pos, dest_pos, max, memory_budget)) {
         levenshtein_align(editops, s1, s2, max, src_pos, dest_pos, editop_pos);
     }
     /* Hirschbergs algorithm */
     else {
-        auto hpos = find_hirschberg_pos(s1, s2, max);
+        auto hpos = find_hirschberg_pos(s1, s2, max, workers);
 
         if (editops.size() == 0) editops.resize(hpos.left_score + hpos.right_score);
 
-        levenshtein_align_hirschberg(editops, s1.subseq(0, hpos.s1_mid), s2.subseq(0, hpos.s2_mid), src_pos,
-                                     dest_pos, editop_pos, hpos.left_score);
-        levenshtein_align_hirschberg(editops, s1.subseq(hpos.s1_mid), s2.subseq(hpos.s2_mid),
-                                     src_pos + hpos.s1_mid, dest_pos + hpos.s2_mid,
-                                     editop_pos + hpos.left_score, hpos.right_score);
+        size_t left_workers = workers / 2;
+        invoke_parallel(
+            workers > 1,
+            [&]() {
+                levenshtein_align_hirschberg(editops, s1.subseq(0, hpos.s1_mid), s2.subseq(0, hpos.s2_mid),
+                                             src_pos, dest_pos, editop_pos, hpos.left_score, left_workers,
+                                             memory_budget);
+            },
+            [&]() {
+                levenshtein_align_hirschberg(editops, s1.subseq(hpos.s1_mid), s2.subseq(hpos.s2_mid),
+                                             src_pos + hpos.s1_mid, dest_pos + hpos.s2_mid,
+                                             editop_pos + hpos.left_score, hpos.right_score,
+                                             workers - left_workers, memory_budget);
+            });
+    }
+}
+
+/*
+ * Hirschbergs algorithm, which passes the edit operations to callback in order. Only the edit
+ * operations of the part that is currently aligned are stored.
+ */
+template <typename InputIt1, typename InputIt2, typename Callback>
+void levenshtein_stream_hirschberg(Callback& callback, Range<InputIt1> s1, Range<InputIt2> s2,
+                                   size_t src_pos, size_t dest_pos, size_t max, size_t memory_budget)
+{
+    if (levenshtein_align_prepare(s1, s2, src_pos, dest_pos, max, memory_budget)) {
+        Editops editops;
+        levenshtein_align(editops, s1, s2, max, src_pos, dest_pos);
+        for (const auto& op : editops)
+            callback(op);
+    }
+    else {
+        auto hpos = find_hirschberg_pos(s1, s2, max);
+        levenshtein_stream_hirschberg(callback, s1.subseq(0, hpos.s1_mid), s2.subseq(0, hpos.s2_mid), src_pos,
+                                      dest_pos, hpos.left_score, memory_budget);
+        levenshtein_stream_hirschberg(callback, s1.subseq(hpos.s1_mid), s2.subseq(hpos.s2_mid),
+                                      src_pos + hpos.s1_mid, dest_pos + hpos.s2_mid, hpos.right_score,
+                                      memory_budget);
     }
 }
 
@@ -1177,10 +1507,10 @@ class Levenshtein : public DistanceBase<Levenshtein, size_t, 0, std::numeric_lim
     }
 };
 
+/* upper bound for the distance used to align s1 and s2 */
 template <typename InputIt1, typename InputIt2>
-Editops levenshtein_editops(const Range<InputIt1>& s1, const Range<InputIt2>& s2, size_t score_hint)
+size_t levenshtein_align_max(const Range<InputIt1>& s1, const Range<InputIt2>& s2, size_t score_hint)
 {
-    Editops editops;
     if (score_hint < 31) score_hint = 31;
 
     size_t score_cutoff = std::max(s1.size(), s2.size());
@@ -1194,11 +1524,40 @@ Editops levenshtein_editops(const Range<InputIt1>& s1, const Range<InputIt2>& s2
     if (std::numeric_limits<size_t>::max() / 2 > score_hint && 2 * score_hint < score_cutoff)
         score_cutoff = Levenshtein::distance(s1, s2, {1, 1, 1}, score_cutoff, score_hint);
 
-    levenshtein_align_hirschberg(editops, s1, s2, 0, 0, 0, score_cutoff);
+    return score_cutoff;
+}
+
+template <typename InputIt1, typename InputIt2>
+Editops levenshtein_editops(const Range<InputIt1>& s1, const Range<InputIt2>& s2, size_t score_hint,
+                            memory_resource* resource = nullptr, size_t workers = 1,
+                            size_t memory_budget = levenshtein_align_memory_budget)
+{
+    if (workers == 0) workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    Editops editops(resource);
+    size_t score_cutoff = levenshtein_align_max(s1, s2, score_hint);
+    levenshtein_align_hirschberg(editops, s1, s2, 0, 0, 0, score_cutoff, workers, memory_budget);
 
     editops.set_src_len(s1.size());
     editops.set_dest_len(s2.size());
     return editops;
 }
 
+template <typename InputIt1, typename InputIt2, typename Callback>
+void levenshtein_for_each_editop(const Range<InputIt1>& s1, const Range<InputIt2>& s2, Callback& callback,
+                                 size_t score_hint, size_t memory_budget)
+{
+    size_t score_cutoff = levenshtein_align_max(s1, s2, score_hint);
+    levenshtein_stream_hirschberg(callback, s1, s2, 0, 0, score_cutoff, memory_budget);
+}
+
+template <typename InputIt1, typename InputIt2, typename Callback>
+void levenshtein_for_each_opcode(const Range<InputIt1>& s1, const Range<InputIt2>& s2, Callback& callback,
+                                 size_t score_hint, size_t memory_budget)
+{
+    OpcodesWriter<Callback&> writer(callback);
+    levenshtein_for_each_editop(s1, s2, writer, score_hint, memory_budget);
+    writer.finish(s1.size(), s2.size());
+}
+
 } // namespace rapidfuzz::detail
@@ -0,0 +1,257 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/distance/Jaro.hpp>
+#include <rapidfuzz/distance/JaroWinkler.hpp>
+#include <rapidfuzz/distance/LCSseq.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/distance/OSA.hpp>
+
+#include <array>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace rapidfuzz {
+
+#ifdef RAPIDFUZZ_SIMD
+namespace experimental {
+
+/**
+ * @brief Compares a string with a list of strings of arbitrary length
+ *
+ * @details
+ * The simd scorers like MultiLevenshtein<MaxLen> only accept strings up to MaxLen.
+ * This sorts the strings into buckets of the simd scorers with MaxLen 8/16/32/64 based
+ * on their length. Longer strings are compared using the cached scorer. The results are
+ * returned in the order the strings were passed in.
+ *
+ * @tparam MultiScorerT simd scorer template, e.g. MultiLevenshtein
+ * @tparam CachedScorerT cached scorer template used for strings longer than 64 characters,
+ *   e.g. CachedLevenshtein
+ * @tparam CharT1 character type of the strings
+ */
+template <template <int> class MultiScorerT, template <typename> class CachedScorerT, typename CharT1,
+          typename ResType, int64_t WorstSimilarity, int64_t WorstDistance>
+struct MultiScorer {
+    /**
+     * @param strings range of strings that are compared with s2
+     * @param args additional arguments passed to the constructor of the simd and cached scorers
+     */
+    template <typename Strings, typename... Args>
+    explicit MultiScorer(const Strings& strings, const Args&... args)
+    {
+        std::array<size_t, 4> bucket_sizes = {};
+        for (const auto& str : strings) {
+            size_t len = static_cast<size_t>(std::distance(detail::to_begin(str), detail::to_end(str)));
+            size_t bucket = find_bucket(len);
+            if (bucket < bucket_sizes.size()) bucket_sizes[bucket]++;
+            input_count++;
+        }
+
+        init_bucket<0>(bucket_sizes[0], args...);
+        init_bucket<1>(bucket_sizes[1], args...);
+        init_bucket<2>(bucket_sizes[2], args...);
+        init_bucket<3>(bucket_sizes[3], args...);
+
+        size_t index = 0;
+        for (const auto& str : strings) {
+            size_t len = static_cast<size_t>(std::distance(detail::to_begin(str), detail::to_end(str)));
+            switch (find_bucket(len)) {
+            case 0: insert_bucket<0>(str, index); break;
+            case 1: insert_bucket<1>(str, index); break;
+            case 2: insert_bucket<2>(str, index); break;
+            case 3: insert_bucket<3>(str, index); break;
+            default:
+                long_scorers.emplace_back(str, args...);
+                long_indices.push_back(index);
+            }
+            index++;
+        }
+    }
+
+    /**
+     * @brief get minimum size required for result vectors passed into
+     * - distance
+     * - similarity
+     * - normalized_distance
+     * - normalized_similarity
+     *
+     * @return minimum vector size
+     */
+    size_t result_count() const
+    {
+        return input_count;
+    }
+
+    template <typename InputIt2>
+    void distance(ResType* scores, size_t score_count, InputIt2 first2, InputIt2 last2,
+                  ResType score_cutoff = static_cast<ResType>(WorstDistance)) const
+    {
+        distance(scores, score_count, detail::Range(first2, last2), score_cutoff);
+    }
+
+    template <typename Sentence2>
+    void distance(ResType* scores, size_t score_count, const Sentence2& s2,
+                  ResType score_cutoff = static_cast<ResType>(WorstDistance)) const
+    {
+        _score(
+            scores, score_count,
+            [&](const auto& scorer, ResType* bucket_scores, size_t bucket_score_count) {
+                scorer.distance(bucket_scores, bucket_score_count, s2, score_cutoff);
+            },
+            [&](const auto& scorer) { return scorer.distance(s2, score_cutoff); });
+    }
+
+    template <typename InputIt2>
+    void similarity(ResType* scores, size_t score_count, InputIt2 first2, InputIt2 last2,
+                    ResType score_cutoff = static_cast<ResType>(WorstSimilarity)) const
+    {
+        similarity(scores, score_count, detail::Range(first2, last2), score_cutoff);
+    }
+
+    template <typename Sentence2>
+    void similarity(ResType* scores, size_t score_count, const Sentence2& s2,
+                    ResType score_cutoff = static_cast<ResType>(WorstSimilarity)) const
+    {
+        _score(
+            scores, score_count,
+            [&](const auto& scorer, ResType* bucket_scores, size_t bucket_score_count) {
+                scorer.similarity(bucket_scores, bucket_score_count, s2, score_cutoff);
+            },
+            [&](const auto& scorer) { return scorer.similarity(s2, score_cutoff); });
+    }
+
+    template <typename InputIt2>
+    void normalized_distance(double* scores, size_t score_count, InputIt2 first2, InputIt2 last2,
+                             double score_cutoff = 1.0) const
+    {
+        normalized_distance(scores, score_count, detail::Range(first2, last2), score_cutoff);
+    }
+
+    template <typename Sentence2>
+    void normalized_distance(double* scores, size_t score_count, const Sentence2& s2,
+                             double score_cutoff = 1.0) const
+    {
+        _score(
+            scores, score_count,
+            [&](const auto& scorer, double* bucket_scores, size_t bucket_score_count) {
+                scorer.normalized_distance(bucket_scores, bucket_score_count, s2, score_cutoff);
+            },
+            [&](const auto& scorer) { return scorer.normalized_distance(s2, score_cutoff); });
+    }
+
+    template <typename InputIt2>
+    void normalized_similarity(double* scores, size_t score_count, InputIt2 first2, InputIt2 last2,
+                               double score_cutoff = 0.0) const
+    {
+        normalized_similarity(scores, score_count, detail::Range(first2, last2), score_cutoff);
+    }
+
+    template <typename Sentence2>
+    void normalized_similarity(double* scores, size_t score_count, const Sentence2& s2,
+                               double score_cutoff = 0.0) const
+    {
+        _score(
+            scores, score_count,
+            [&](const auto& scorer, double* bucket_scores, size_t bucket_score_count) {
+                scorer.normalized_similarity(bucket_scores, bucket_score_count, s2, score_cutoff);
+            },
+            [&](const auto& scorer) { return scorer.normalized_similarity(s2, score_cutoff); });
+    }
+
+private:
+    static constexpr std::array<size_t, 4> bucket_max_len = {8, 16, 32, 64};
+
+    static size_t find_bucket(size_t len)
+    {
+        if (len <= 8) return 0;
+        if (len <= 16) return 1;
+        if (len <= 32) return 2;
+        if (len <= 64) return 3;
+        return 4;
+    }
+
+    template <size_t Bucket>
+    using bucket_scorer = MultiScorerT<static_cast<int>(bucket_max_len[Bucket])>;
+
+    template <size_t Bucket, typename... Args>
+    void init_bucket(size_t count, const Args&... args)
+    {
+        if (!count) return;
+        std::get<Bucket>(buckets) = std::make_unique<bucket_scorer<Bucket>>(count, args...);
+        bucket_indices[Bucket].reserve(count);
+    }
+
+    template <size_t Bucket, typename Sentence1>
+    void insert_bucket(const Sentence1& s1, size_t index)
+    {
+        std::get<Bucket>(buckets)->insert(s1);
+        bucket_indices[Bucket].push_back(index);
+    }
+
+    template <typename ScoreT, typename MultiFunc, typename CachedFunc>
+    void _score(ScoreT* scores, size_t score_count, MultiFunc&& multi_func, CachedFunc&& cached_func) const
+    {
+        if (score_count < result_count())
+            throw std::invalid_argument("scores has to have >= result_count() elements");
+
+        std::vector<ScoreT> bucket_scores;
+        auto score_bucket = [&](const auto& scorer, const std::vector<size_t>& indices) {
+            if (!scorer) return;
+            bucket_scores.resize(scorer->result_count());
+            multi_func(*scorer, bucket_scores.data(), bucket_scores.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+                scores[indices[i]] = bucket_scores[i];
+        };
+
+        score_bucket(std::get<0>(buckets), bucket_indices[0]);
+        score_bucket(std::get<1>(buckets), bucket_indices[1]);
+        score_bucket(std::get<2>(buckets), bucket_indices[2]);
+        score_bucket(std::get<3>(buckets), bucket_indices[3]);
+
+        for (size_t i = 0; i < long_scorers.size(); ++i)
+            scores[long_indices[i]] = cached_func(long_scorers[i]);
+    }
+
+    size_t input_count = 0;
+    std::tuple<std::unique_ptr<bucket_scorer<0>>, std::unique_ptr<bucket_scorer<1>>,
+               std::unique_ptr<bucket_scorer<2>>, std::unique_ptr<bucket_scorer<3>>>
+        buckets;
+    std::array<std::vector<size_t>, 4> bucket_indices;
+    std::vector<CachedScorerT<CharT1>> long_scorers;
+    std::vector<size_t> long_indices;
+};
+
+template <typename CharT1>
+using MultiScorerLevenshtein =
+    MultiScorer<MultiLevenshtein, CachedLevenshtein, CharT1, size_t, 0, std::numeric_limits<int64_t>::max()>;
+
+template <typename CharT1>
+using MultiScorerOSA =
+    MultiScorer<MultiOSA, CachedOSA, CharT1, size_t, 0, std::numeric_limits<int64_t>::max()>;
+
+template <typename CharT1>
+using MultiScorerIndel =
+    MultiScorer<MultiIndel, CachedIndel, CharT1, size_t, 0, std::numeric_limits<int64_t>::max()>;
+
+template <typename CharT1>
+using MultiScorerLCSseq =
+    MultiScorer<MultiLCSseq, CachedLCSseq, CharT1, size_t, 0, std::numeric_limits<int64_t>::max()>;
+
+template <typename CharT1>
+using MultiScorerJaro = MultiScorer<MultiJaro, CachedJaro, CharT1, double, 0, 1>;
+
+template <typename CharT1>
+using MultiScorerJaroWinkler = MultiScorer<MultiJaroWinkler, CachedJaroWinkler, CharT1, double, 0, 1>;
+
+} /* namespace experimental */
+#endif /* RAPIDFUZZ_SIMD */
+
+} // namespace rapidfuzz
@@ -121,7 +121,9 @@ private:
 
     constexpr static size_t get_vec_size()
     {
-#    ifdef RAPIDFUZZ_AVX2
+#    if defined(RAPIDFUZZ_AVX512)
+        using namespace detail::simd_avx512;
+#    elif defined(RAPIDFUZZ_AVX2)
         using namespace detail::simd_avx2;
 #    else
         using namespace detail::simd_sse2;
@@ -232,14 +234,38 @@ private:
 template <typename CharT1>
 struct CachedOSA
     : public detail::CachedDistanceBase<CachedOSA<CharT1>, size_t, 0, std::numeric_limits<int64_t>::max()> {
+    /**
+     * @param resource memory_resource used to allocate the cached data or nullptr to use the
+     * global heap
+     */
     template <typename Sentence1>
-    explicit CachedOSA(const Sentence1& s1_) : CachedOSA(detail::to_begin(s1_), detail::to_end(s1_))
+    explicit CachedOSA(const Sentence1& s1_, memory_resource* resource = nullptr)
+        : CachedOSA(detail::to_begin(s1_), detail::to_end(s1_), resource)
     {}
 
     template <typename InputIt1>
-    CachedOSA(InputIt1 first1, InputIt1 last1) : s1(first1, last1), PM(detail::Range(first1, last1))
+    CachedOSA(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+        : s1(first1, last1, resource), PM(detail::Range(first1, last1), resource)
+    {}
+
+    /**
+     * @brief creates the scorer from a precomputed BlockPatternMatchVector of s1, e.g. a view
+     * of a serialized BlockPatternMatchVector
+     *
+     * @throws std::invalid_argument when the BlockPatternMatchVector does not match the length of s1
+     */
+    template <typename Sentence1>
+    CachedOSA(const Sentence1& s1_, detail::BlockPatternMatchVector PM_)
+        : CachedOSA(detail::to_begin(s1_), detail::to_end(s1_), std::move(PM_))
     {}
 
+    template <typename InputIt1>
+    CachedOSA(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+        : s1(first1, last1), PM(std::move(PM_))
+    {
+        detail::check_pattern_match_vector(PM, s1.size());
+    }
+
 private:
     friend detail::CachedDistanceBase<CachedOSA<CharT1>, size_t, 0, std::numeric_limits<int64_t>::max()>;
     friend detail::CachedNormalizedMetricBase<CachedOSA<CharT1>>;
@@ -267,15 +293,24 @@ private:
         return (res <= score_cutoff) ? res : score_cutoff + 1;
     }
 
-    std::vector<CharT1> s1;
+    std::vector<CharT1, detail::ResourceAllocator<CharT1>> s1;
     detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
-CachedOSA(const Sentence1& s1_) -> CachedOSA<char_type<Sentence1>>;
+CachedOSA(const Sentence1& s1_, memory_resource* resource = nullptr)
+    -> CachedOSA<char_type<Sentence1>>;
+
+template <typename InputIt1>
+CachedOSA(InputIt1 first1, InputIt1 last1, memory_resource* resource = nullptr)
+    -> CachedOSA<iter_value_t<InputIt1>>;
+
+template <typename Sentence1>
+CachedOSA(const Sentence1& s1_, detail::BlockPatternMatchVector PM_) -> CachedOSA<char_type<Sentence1>>;
 
 template <typename InputIt1>
-CachedOSA(InputIt1 first1, InputIt1 last1) -> CachedOSA<iter_value_t<InputIt1>>;
+CachedOSA(InputIt1 first1, InputIt1 last1, detail::BlockPatternMatchVector PM_)
+    -> CachedOSA<iter_value_t<InputIt1>>;
 /**@}*/
 
 } // namespace rapidfuzz
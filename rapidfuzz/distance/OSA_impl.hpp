@@ -73,16 +73,11 @@ size_t osa_hyrroe2003(const PM_Vec& PM, const Range<InputIt1>& s1, const Range<I
 }
 
 #ifdef RAPIDFUZZ_SIMD
-template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
-void osa_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
-                         const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
-                         size_t score_cutoff) noexcept
+template <template <typename> class native_simd, typename VecType, typename InputIt>
+void osa_hyrroe2003_simd_impl(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                              const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                              size_t score_cutoff) noexcept
 {
-#    ifdef RAPIDFUZZ_AVX2
-    using namespace simd_avx2;
-#    else
-    using namespace simd_sse2;
-#    endif
     static constexpr size_t alignment = native_simd<VecType>::alignment;
     static constexpr size_t vec_width = native_simd<VecType>::size;
     static constexpr size_t vecs = native_simd<uint64_t>::size;
@@ -168,6 +163,17 @@ void osa_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatternMatchV
         });
     }
 }
+
+template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void osa_hyrroe2003_simd(Range<size_t*> scores, const detail::BlockPatternMatchVector& block,
+                         const std::vector<size_t>& s1_lengths, const Range<InputIt>& s2,
+                         size_t score_cutoff) noexcept
+{
+    simd_dispatch([&](auto simd) {
+        osa_hyrroe2003_simd_impl<decltype(simd)::template native_simd, VecType>(scores, block, s1_lengths,
+                                                                                s2, score_cutoff);
+    });
+}
 #endif
 
 template <typename InputIt1, typename InputIt2>
@@ -187,6 +187,8 @@ private:
     std::vector<CharT1> s1;
     rapidfuzz::detail::CharSet<CharT1> s1_char_set;
     CachedRatio<CharT1> cached_ratio;
+    /* bitvectors used to score all windows at once. Only calculated for s1 with <= 64 characters */
+    rapidfuzz::detail::BlockPatternMatchVector PM;
 };
 
 template <typename Sentence1>
@@ -637,7 +639,14 @@ double WRatio(const Sentence1& s1, const Sentence2& s2, double score_cutoff = 0)
 template <typename InputIt1, typename InputIt2>
 double WRatio(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, double score_cutoff = 0);
 
-// todo add real implementation
+/**
+ * @brief cached version of WRatio
+ *
+ * @details
+ * The tokenization of s1 and the bitvectors of s1 and its sorted tokens are calculated once
+ * and shared by all ratios calculated by WRatio. Ratios, which can not reach the score_cutoff
+ * after scaling with UNBASE_SCALE / PARTIAL_SCALE are skipped.
+ */
 template <typename CharT1>
 struct CachedWRatio {
     template <typename InputIt1>
@@ -655,13 +664,12 @@ struct CachedWRatio {
     double similarity(const Sentence2& s2, double score_cutoff = 0.0, double score_hint = 0.0) const;
 
 private:
-    // todo somehow implement this using other ratios with creating PatternMatchVector
-    // multiple times
     std::vector<CharT1> s1;
     CachedPartialRatio<CharT1> cached_partial_ratio;
     detail::SplittedSentenceView<typename std::vector<CharT1>::iterator> tokens_s1;
     std::vector<CharT1> s1_sorted;
-    rapidfuzz::detail::BlockPatternMatchVector blockmap_s1_sorted;
+    /* its CachedRatio is used by token_ratio as well */
+    CachedPartialRatio<CharT1> cached_partial_ratio_s1_sorted;
 };
 
 template <typename Sentence1>
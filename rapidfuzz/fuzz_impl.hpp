@@ -6,7 +6,9 @@
 #include <rapidfuzz/details/CharSet.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <iterator>
 #include <sys/types.h>
 #include <vector>
@@ -63,10 +65,135 @@ static inline size_t score_cutoff_to_distance(double score_cutoff, size_t lensum
     return static_cast<size_t>(std::ceil(static_cast<double>(lensum) * (1.0 - score_cutoff / 100)));
 }
 
+/**
+ * @brief calculates the LCS of s1 and the prefixes of s2 with a length in [1, lcs.size()) in a
+ * single pass of the bit-parallel LCS. s1 has to be <= 64 characters.
+ */
+template <typename InputIt>
+void partial_ratio_prefix_lcs(std::vector<size_t>& lcs, const detail::BlockPatternMatchVector& PM,
+                              InputIt first2)
+{
+    uint64_t S = ~UINT64_C(0);
+    for (size_t i = 1; i < lcs.size(); ++i, ++first2) {
+        uint64_t u = S & PM.get(0, *first2);
+        S = (S + u) | (S - u);
+        lcs[i] = detail::popcount(~S);
+    }
+}
+
+/**
+ * @brief calculates the LCS of s1 and the suffixes of s2 with a length in [1, lcs.size()). Since
+ * LCS(s1, s2) = LCS(reversed s1, reversed s2), they are calculated by processing s2 backwards using
+ * the bit reversed match masks.
+ */
+template <typename InputIt>
+void partial_ratio_suffix_lcs(std::vector<size_t>& lcs, const detail::BlockPatternMatchVector& PM,
+                              size_t len1, InputIt last2)
+{
+    uint64_t S = ~UINT64_C(0);
+    for (size_t i = 1; i < lcs.size(); ++i) {
+        --last2;
+        uint64_t u = S & (detail::bit_reverse(PM.get(0, *last2)) >> (64 - len1));
+        S = (S + u) | (S - u);
+        lcs[i] = detail::popcount(~S);
+    }
+}
+
+/**
+ * @brief converts the LCS of s1 and s2 into the result cached_ratio.similarity would return
+ */
+static inline double lcs_to_ratio(size_t lcs, size_t len1, size_t len2, double score_cutoff)
+{
+    size_t maximum = len1 + len2;
+    size_t dist = maximum - 2 * lcs;
+    double norm_cutoff = rapidfuzz::detail::NormSim_to_NormDist(score_cutoff / 100);
+    auto cutoff_dist = static_cast<size_t>(std::ceil(static_cast<double>(maximum) * norm_cutoff));
+
+    double norm_dist = static_cast<double>(dist) / static_cast<double>(maximum);
+    if (dist > cutoff_dist || norm_dist > norm_cutoff) norm_dist = 1.0;
+
+    double norm_sim = 1.0 - norm_dist;
+    return ((norm_sim >= score_cutoff / 100) ? norm_sim : 0.0) * 100;
+}
+
+#ifdef RAPIDFUZZ_SIMD
+/**
+ * @brief calculates the Indel distance between s1 and all substrings of s2 with the length of s1,
+ * which start in the range [0, scores.size())
+ *
+ * @details
+ * Every lane of the simd vectors calculates the LCS of s1 and a different window. The windows of
+ * neighbouring lanes are shifted by one character, so the match masks of all lanes can be loaded
+ * from the match masks of the characters in s2 at once. s1 has to fit into a single VecType.
+ */
+template <template <typename> class native_simd, typename VecType, typename InputIt>
+void partial_ratio_windows_simd_impl(detail::Range<size_t*> scores, const detail::BlockPatternMatchVector& PM,
+                                     size_t len1, const detail::Range<InputIt>& s2)
+{
+    static constexpr size_t lanes = native_simd<VecType>::size;
+
+    /* padded with zeros, so the last vector can be loaded */
+    std::vector<VecType> matches(scores.size() + len1 + lanes);
+    for (size_t i = 0; i < scores.size() + len1 - 1; ++i)
+        matches[i] = static_cast<VecType>(PM.get(0, s2[i]));
+
+    for (size_t start = 0; start < scores.size(); start += lanes) {
+        native_simd<VecType> S = static_cast<VecType>(-1);
+
+        for (size_t i = 0; i < len1; ++i) {
+            /* unaligned load, which is not provided by native_simd */
+            native_simd<VecType> Matches;
+            std::memcpy(&Matches.xmm, &matches[start + i], sizeof(Matches.xmm));
+
+            native_simd<VecType> u = S & Matches;
+            S = (S + u) | (S - u);
+        }
+
+        auto counts = popcount(~S);
+        for (size_t i = 0; i < lanes && start + i < scores.size(); ++i)
+            scores[start + i] = 2 * (len1 - static_cast<size_t>(counts[i]));
+    }
+}
+
+template <typename VecType, typename InputIt, int _lto_hack = RAPIDFUZZ_LTO_HACK>
+void partial_ratio_windows_simd(detail::Range<size_t*> scores, const detail::BlockPatternMatchVector& PM,
+                                size_t len1, const detail::Range<InputIt>& s2)
+{
+    detail::simd_dispatch([&](auto simd) {
+        partial_ratio_windows_simd_impl<decltype(simd)::template native_simd, VecType>(scores, PM, len1, s2);
+    });
+}
+
+/**
+ * @brief calculates the Indel distance of all windows using the simd implementation.
+ *
+ * @return false when the windows should be calculated one by one instead
+ */
+template <typename InputIt>
+bool partial_ratio_windows(std::vector<size_t>& scores, const detail::BlockPatternMatchVector& PM,
+                           size_t len1, const detail::Range<InputIt>& s2)
+{
+    /* the simd implementation calculates every window, while the bisection often only calculates
+     * a small part of them. This only pays off for needles, which fit into the smaller lanes */
+    if (len1 > 64 || scores.size() < 8) return false;
+
+    auto scores_ = detail::Range(scores.data(), scores.data() + scores.size());
+    if (len1 <= 8)
+        partial_ratio_windows_simd<uint8_t>(scores_, PM, len1, s2);
+    else if (len1 <= 16)
+        partial_ratio_windows_simd<uint16_t>(scores_, PM, len1, s2);
+    else if (len1 <= 32)
+        partial_ratio_windows_simd<uint32_t>(scores_, PM, len1, s2);
+    else
+        partial_ratio_windows_simd<uint64_t>(scores_, PM, len1, s2);
+    return true;
+}
+#endif
+
 template <typename InputIt1, typename InputIt2, typename CachedCharT1>
 ScoreAlignment<double>
 partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputIt2>& s2,
-                   const CachedRatio<CachedCharT1>& cached_ratio,
+                   const CachedRatio<CachedCharT1>& cached_ratio, const detail::BlockPatternMatchVector& PM,
                    const detail::CharSet<iter_value_t<InputIt1>>& s1_char_set, double score_cutoff)
 {
     ScoreAlignment<double> res;
@@ -86,6 +213,16 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
         std::vector<std::pair<size_t, size_t>> windows = {{0, len2 - len1 - 1}};
         std::vector<std::pair<size_t, size_t>> new_windows;
 
+        /* the windows are still visited in the order of the bisection, so ties are resolved the same way */
+        std::vector<size_t> window_scores;
+#ifdef RAPIDFUZZ_SIMD
+        window_scores.resize(len2 - len1);
+        if (!partial_ratio_windows(window_scores, PM, len1, s2)) window_scores.clear();
+#endif
+        auto window_distance = [&](size_t window, const auto& subseq) {
+            return window_scores.empty() ? cached_ratio.cached_indel.distance(subseq) : window_scores[window];
+        };
+
         while (!windows.empty()) {
             for (const auto& window : windows) {
                 auto subseq1_first = s2.begin() + static_cast<ptrdiff_t>(window.first);
@@ -94,7 +231,7 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
                 detail::Range subseq2(subseq2_first, subseq2_first + static_cast<ptrdiff_t>(len1));
 
                 if (scores[window.first] == std::numeric_limits<size_t>::max()) {
-                    scores[window.first] = cached_ratio.cached_indel.distance(subseq1);
+                    scores[window.first] = window_distance(window.first, subseq1);
                     if (scores[window.first] < cutoff_dist) {
                         cutoff_dist = best_dist = scores[window.first];
                         res.dest_start = window.first;
@@ -106,7 +243,7 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
                     }
                 }
                 if (scores[window.second] == std::numeric_limits<size_t>::max()) {
-                    scores[window.second] = cached_ratio.cached_indel.distance(subseq2);
+                    scores[window.second] = window_distance(window.second, subseq2);
                     if (scores[window.second] < cutoff_dist) {
                         cutoff_dist = best_dist = scores[window.second];
                         res.dest_start = window.second;
@@ -143,11 +280,19 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
         if (score >= score_cutoff) score_cutoff = res.score = score;
     }
 
+    /* for short needles the LCS of all prefixes / suffixes shorter than s1 is calculated at once */
+    std::vector<size_t> affix_lcs;
+    if (len1 <= 64) {
+        affix_lcs.resize(len1);
+        partial_ratio_prefix_lcs(affix_lcs, PM, s2.begin());
+    }
+
     for (size_t i = 1; i < len1; ++i) {
         rapidfuzz::detail::Range subseq(s2.begin(), s2.begin() + static_cast<ptrdiff_t>(i));
         if (!s1_char_set.find(subseq.back())) continue;
 
-        double ls_ratio = cached_ratio.similarity(subseq, score_cutoff);
+        double ls_ratio = affix_lcs.empty() ? cached_ratio.similarity(subseq, score_cutoff)
+                                            : lcs_to_ratio(affix_lcs[i], len1, i, score_cutoff);
         if (ls_ratio > res.score) {
             score_cutoff = res.score = ls_ratio;
             res.dest_start = 0;
@@ -156,11 +301,17 @@ partial_ratio_impl(const detail::Range<InputIt1>& s1, const detail::Range<InputI
         }
     }
 
+    if (!affix_lcs.empty()) {
+        affix_lcs.resize(len1 + 1);
+        partial_ratio_suffix_lcs(affix_lcs, PM, len1, s2.end());
+    }
+
     for (size_t i = len2 - len1; i < len2; ++i) {
         rapidfuzz::detail::Range subseq(s2.begin() + static_cast<ptrdiff_t>(i), s2.end());
         if (!s1_char_set.find(subseq.front())) continue;
 
-        double ls_ratio = cached_ratio.similarity(subseq, score_cutoff);
+        double ls_ratio = affix_lcs.empty() ? cached_ratio.similarity(subseq, score_cutoff)
+                                            : lcs_to_ratio(affix_lcs[len2 - i], len1, len2 - i, score_cutoff);
         if (ls_ratio > res.score) {
             score_cutoff = res.score = ls_ratio;
             res.dest_start = i;
@@ -177,12 +328,14 @@ ScoreAlignment<double> partial_ratio_impl(const detail::Range<InputIt1>& s1,
                                           const detail::Range<InputIt2>& s2, double score_cutoff)
 {
     CachedRatio<CharT1> cached_ratio(s1);
+    detail::BlockPatternMatchVector PM = (s1.size() <= 64) ? detail::BlockPatternMatchVector(s1)
+                                                           : detail::BlockPatternMatchVector(0);
 
     detail::CharSet<CharT1> s1_char_set;
     for (auto ch : s1)
         s1_char_set.insert(ch);
 
-    return partial_ratio_impl(s1, s2, cached_ratio, s1_char_set, score_cutoff);
+    return partial_ratio_impl(s1, s2, cached_ratio, PM, s1_char_set, score_cutoff);
 }
 
 } // namespace fuzz_detail
@@ -245,7 +398,10 @@ double partial_ratio(const Sentence1& s1, const Sentence2& s2, double score_cuto
 template <typename CharT1>
 template <typename InputIt1>
 CachedPartialRatio<CharT1>::CachedPartialRatio(InputIt1 first1, InputIt1 last1)
-    : s1(first1, last1), cached_ratio(first1, last1)
+    : s1(first1, last1),
+      cached_ratio(first1, last1),
+      PM((s1.size() <= 64) ? detail::BlockPatternMatchVector(detail::Range(s1))
+                           : detail::BlockPatternMatchVector(0))
 {
     for (const auto& ch : s1)
         s1_char_set.insert(ch);
@@ -269,7 +425,8 @@ double CachedPartialRatio<CharT1>::similarity(InputIt2 first2, InputIt2 last2, d
     auto s1_ = detail::Range(s1);
     auto s2 = detail::Range(first2, last2);
 
-    double score = fuzz_detail::partial_ratio_impl(s1_, s2, cached_ratio, s1_char_set, score_cutoff).score;
+    double score =
+        fuzz_detail::partial_ratio_impl(s1_, s2, cached_ratio, PM, s1_char_set, score_cutoff).score;
     if (score != 100 && s1_.size() == s2.size()) {
         score_cutoff = std::max(score_cutoff, score);
         double score2 = fuzz_detail::partial_ratio_impl(s2, s1_, score_cutoff).score;
@@ -619,66 +776,6 @@ double token_ratio(const rapidfuzz::detail::SplittedSentenceView<CharT1>& s1_tok
 
     return std::max({result, sect_ab_ratio, sect_ba_ratio});
 }
-
-// todo this is a temporary solution until WRatio is properly implemented using other scorers
-template <typename CharT1, typename InputIt1, typename InputIt2>
-double token_ratio(const std::vector<CharT1>& s1_sorted,
-                   const rapidfuzz::detail::SplittedSentenceView<InputIt1>& tokens_s1,
-                   const detail::BlockPatternMatchVector& blockmap_s1_sorted, InputIt2 first2, InputIt2 last2,
-                   double score_cutoff)
-{
-    if (score_cutoff > 100) return 0;
-
-    auto tokens_b = detail::sorted_split(first2, last2);
-
-    auto decomposition = detail::set_decomposition(tokens_s1, tokens_b);
-    auto intersect = decomposition.intersection;
-    auto diff_ab = decomposition.difference_ab;
-    auto diff_ba = decomposition.difference_ba;
-
-    if (!intersect.empty() && (diff_ab.empty() || diff_ba.empty())) return 100;
-
-    auto diff_ab_joined = diff_ab.join();
-    auto diff_ba_joined = diff_ba.join();
-
-    size_t ab_len = diff_ab_joined.size();
-    size_t ba_len = diff_ba_joined.size();
-    size_t sect_len = intersect.length();
-
-    double result = 0;
-    auto s2_sorted = tokens_b.join();
-    if (s1_sorted.size() < 65) {
-        double norm_sim = detail::indel_normalized_similarity(blockmap_s1_sorted, detail::Range(s1_sorted),
-                                                              detail::Range(s2_sorted), score_cutoff / 100);
-        result = norm_sim * 100;
-    }
-    else {
-        result = fuzz::ratio(s1_sorted, s2_sorted, score_cutoff);
-    }
-
-    // string length sect+ab <-> sect and sect+ba <-> sect
-    size_t sect_ab_len = sect_len + bool(sect_len) + ab_len;
-    size_t sect_ba_len = sect_len + bool(sect_len) + ba_len;
-
-    size_t cutoff_distance = score_cutoff_to_distance(score_cutoff, sect_ab_len + sect_ba_len);
-    size_t dist = indel_distance(diff_ab_joined, diff_ba_joined, cutoff_distance);
-    if (dist <= cutoff_distance)
-        result = std::max(result, norm_distance(dist, sect_ab_len + sect_ba_len, score_cutoff));
-
-    // exit early since the other ratios are 0
-    if (!sect_len) return result;
-
-    // levenshtein distance sect+ab <-> sect and sect+ba <-> sect
-    // since only sect is similar in them the distance can be calculated based on
-    // the length difference
-    size_t sect_ab_dist = bool(sect_len) + ab_len;
-    double sect_ab_ratio = norm_distance(sect_ab_dist, sect_len + sect_ab_len, score_cutoff);
-
-    size_t sect_ba_dist = bool(sect_len) + ba_len;
-    double sect_ba_ratio = norm_distance(sect_ba_dist, sect_len + sect_ba_len, score_cutoff);
-
-    return std::max({result, sect_ab_ratio, sect_ba_ratio});
-}
 } // namespace fuzz_detail
 
 template <typename CharT1>
@@ -765,6 +862,34 @@ double partial_token_ratio(const std::vector<CharT1>& s1_sorted,
     return std::max(result, partial_ratio(diff_ab.join(), diff_ba.join(), score_cutoff));
 }
 
+template <typename CharT1, typename InputIt1, typename InputIt2>
+double partial_token_ratio(const CachedPartialRatio<CharT1>& cached_partial_ratio_s1_sorted,
+                           const rapidfuzz::detail::SplittedSentenceView<InputIt1>& tokens_s1,
+                           InputIt2 first2, InputIt2 last2, double score_cutoff)
+{
+    if (score_cutoff > 100) return 0;
+
+    auto tokens_b = detail::sorted_split(first2, last2);
+
+    auto decomposition = detail::set_decomposition(tokens_s1, tokens_b);
+
+    // exit early when there is a common word in both sequences
+    if (!decomposition.intersection.empty()) return 100;
+
+    auto diff_ab = decomposition.difference_ab;
+    auto diff_ba = decomposition.difference_ba;
+
+    double result = cached_partial_ratio_s1_sorted.similarity(tokens_b.join(), score_cutoff);
+
+    // do not calculate the same partial_ratio twice
+    if (tokens_s1.word_count() == diff_ab.word_count() && tokens_b.word_count() == diff_ba.word_count()) {
+        return result;
+    }
+
+    score_cutoff = std::max(score_cutoff, result);
+    return std::max(result, partial_ratio(diff_ab.join(), diff_ba.join(), score_cutoff));
+}
+
 } // namespace fuzz_detail
 
 template <typename CharT1>
@@ -808,16 +933,20 @@ double WRatio(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2,
 
     if (len_ratio < 1.5) {
         score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
+        /* the scaled token_ratio can not reach the score_cutoff */
+        if (score_cutoff > 100) return end_ratio;
         return std::max(end_ratio, token_ratio(first1, last1, first2, last2, score_cutoff) * UNBASE_SCALE);
     }
 
     const double PARTIAL_SCALE = (len_ratio < 8.0) ? 0.9 : 0.6;
 
     score_cutoff = std::max(score_cutoff, end_ratio) / PARTIAL_SCALE;
+    if (score_cutoff > 100) return end_ratio;
     end_ratio =
         std::max(end_ratio, partial_ratio(first1, last1, first2, last2, score_cutoff) * PARTIAL_SCALE);
 
-    score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
+    score_cutoff = std::max(score_cutoff, end_ratio / PARTIAL_SCALE) / UNBASE_SCALE;
+    if (score_cutoff > 100) return end_ratio;
     return std::max(end_ratio, partial_token_ratio(first1, last1, first2, last2, score_cutoff) *
                                    UNBASE_SCALE * PARTIAL_SCALE);
 }
@@ -836,7 +965,7 @@ CachedWRatio<Sentence1>::CachedWRatio(InputIt1 first1, InputIt1 last1)
       cached_partial_ratio(first1, last1),
       tokens_s1(detail::sorted_split(std::begin(s1), std::end(s1))),
       s1_sorted(tokens_s1.join()),
-      blockmap_s1_sorted(detail::Range(s1_sorted))
+      cached_partial_ratio_s1_sorted(s1_sorted)
 {}
 
 template <typename CharT1>
@@ -862,20 +991,24 @@ double CachedWRatio<CharT1>::similarity(InputIt2 first2, InputIt2 last2, double
 
     if (len_ratio < 1.5) {
         score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
-        // use pre calculated values
-        auto r =
-            fuzz_detail::token_ratio(s1_sorted, tokens_s1, blockmap_s1_sorted, first2, last2, score_cutoff);
+        /* the scaled token_ratio can not reach the score_cutoff */
+        if (score_cutoff > 100) return end_ratio;
+        const auto& cached_ratio_s1_sorted = cached_partial_ratio_s1_sorted.cached_ratio;
+        auto r = fuzz_detail::token_ratio(tokens_s1, cached_ratio_s1_sorted, first2, last2, score_cutoff);
         return std::max(end_ratio, r * UNBASE_SCALE);
     }
 
     const double PARTIAL_SCALE = (len_ratio < 8.0) ? 0.9 : 0.6;
 
     score_cutoff = std::max(score_cutoff, end_ratio) / PARTIAL_SCALE;
+    if (score_cutoff > 100) return end_ratio;
     end_ratio =
         std::max(end_ratio, cached_partial_ratio.similarity(first2, last2, score_cutoff) * PARTIAL_SCALE);
 
-    score_cutoff = std::max(score_cutoff, end_ratio) / UNBASE_SCALE;
-    auto r = fuzz_detail::partial_token_ratio(s1_sorted, tokens_s1, first2, last2, score_cutoff);
+    score_cutoff = std::max(score_cutoff, end_ratio / PARTIAL_SCALE) / UNBASE_SCALE;
+    if (score_cutoff > 100) return end_ratio;
+    auto r = fuzz_detail::partial_token_ratio(cached_partial_ratio_s1_sorted, tokens_s1, first2, last2,
+                                              score_cutoff);
     return std::max(end_ratio, r * UNBASE_SCALE * PARTIAL_SCALE);
 }
 
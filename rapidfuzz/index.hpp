@@ -0,0 +1,7 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/index/BKTree.hpp>
+#include <rapidfuzz/index/LevenshteinTrie.hpp>
+#include <rapidfuzz/index/QGramIndex.hpp>
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/Range.hpp>
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/distance/OSA.hpp>
+#include <rapidfuzz/process.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rapidfuzz {
+
+/**
+ * @brief Burkhard-Keller tree, which finds similar strings using the triangle inequality
+ *
+ * @details
+ * Every child is stored with its distance to the parent. When a node has the distance d
+ * to the query, only children with a distance in [d - k, d + k] can contain strings within
+ * the distance k of the query. The distance to a node is calculated using
+ * `score_cutoff = k + max child distance`, since no child can match once the distance
+ * exceeds this bound. For the small distances typically used, this allows the scorers to
+ * use the implementations optimized for a low score_cutoff.
+ *
+ * @tparam CachedScorer cached scorer template of a metric, e.g. CachedLevenshtein with
+ *   uniform weights or experimental::CachedDamerauLevenshtein. CachedOSA is not supported,
+ *   since the optimal string alignment distance does not satisfy the triangle inequality
+ *   (OSA("ca", "abc") = 3 > OSA("ca", "ac") + OSA("ac", "abc") = 2).
+ * @tparam CharT character type of the stored strings
+ */
+template <template <typename> class CachedScorer, typename CharT>
+class BKTree {
+    static_assert(!std::is_same_v<CachedScorer<CharT>, CachedOSA<CharT>>,
+                  "OSA does not satisfy the triangle inequality");
+
+public:
+    /**
+     * @brief adds a string to the tree
+     *
+     * @return index of the string, which is returned by search and nearest
+     */
+    template <typename InputIt>
+    size_t insert(InputIt first, InputIt last)
+    {
+        size_t index = m_strings.size();
+        m_strings.emplace_back(first, last);
+        m_nodes.emplace_back();
+        if (index == 0) return index;
+
+        CachedScorer<CharT> scorer(m_strings.back());
+        size_t node = 0;
+        while (true) {
+            size_t dist = scorer.distance(m_strings[node]);
+            auto& children = m_nodes[node].children;
+            auto child = std::find_if(children.begin(), children.end(),
+                                      [&](const auto& c) { return c.first == dist; });
+            if (child == children.end()) {
+                children.emplace_back(dist, index);
+                m_nodes[node].max_child_dist = std::max(m_nodes[node].max_child_dist, dist);
+                return index;
+            }
+            node = child->second;
+        }
+    }
+
+    template <typename Sentence>
+    size_t insert(const Sentence& s)
+    {
+        return insert(detail::to_begin(s), detail::to_end(s));
+    }
+
+    /**
+     * @return number of strings in the tree
+     */
+    size_t size() const noexcept
+    {
+        return m_strings.size();
+    }
+
+    /**
+     * @brief finds all strings with a distance <= max_dist
+     *
+     * @return matches with their distance as score, sorted by distance and index
+     */
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>> search(InputIt first, InputIt last, size_t max_dist) const
+    {
+        std::vector<process::ExtractResult<size_t>> results;
+        if (m_nodes.empty()) return results;
+
+        CachedScorer<CharT> scorer(first, last);
+        std::vector<size_t> stack = {0};
+        while (!stack.empty()) {
+            size_t node = stack.back();
+            stack.pop_back();
+
+            size_t dist = scorer.distance(m_strings[node], cutoff(max_dist, m_nodes[node].max_child_dist));
+            if (dist <= max_dist) results.push_back({dist, node});
+
+            for (const auto& [child_dist, child] : m_nodes[node].children)
+                if (detail::abs_diff(child_dist, dist) <= max_dist) stack.push_back(child);
+        }
+
+        std::sort(results.begin(), results.end(), result_less);
+        return results;
+    }
+
+    template <typename Sentence>
+    std::vector<process::ExtractResult<size_t>> search(const Sentence& s, size_t max_dist) const
+    {
+        return search(detail::to_begin(s), detail::to_end(s), max_dist);
+    }
+
+    /**
+     * @brief finds the limit closest strings with a distance <= max_dist
+     *
+     * @details
+     * The distance of the worst match found so far is used as search radius, so
+     * the search space shrinks while the tree is traversed.
+     *
+     * @return matches with their distance as score, sorted by distance and index
+     */
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>>
+    nearest(InputIt first, InputIt last, size_t limit,
+            size_t max_dist = std::numeric_limits<size_t>::max()) const
+    {
+        /* heap with the worst result at the front */
+        std::vector<process::ExtractResult<size_t>> results;
+        if (m_nodes.empty() || limit == 0) return results;
+
+        CachedScorer<CharT> scorer(first, last);
+        size_t radius = max_dist;
+        /* nodes to visit with the lower bound of the distance of their subtree */
+        std::vector<std::pair<size_t, size_t>> stack = {{0, 0}};
+        std::vector<std::pair<size_t, size_t>> next_children;
+        while (!stack.empty()) {
+            auto [min_dist, node] = stack.back();
+            stack.pop_back();
+            /* the radius might have shrunk since the node was added */
+            if (min_dist > radius) continue;
+
+            size_t dist = scorer.distance(m_strings[node], cutoff(radius, m_nodes[node].max_child_dist));
+            if (dist <= radius) {
+                process::ExtractResult<size_t> result = {dist, node};
+                if (results.size() < limit) {
+                    results.push_back(result);
+                    std::push_heap(results.begin(), results.end(), result_less);
+                }
+                else if (result_less(result, results.front())) {
+                    std::pop_heap(results.begin(), results.end(), result_less);
+                    results.back() = result;
+                    std::push_heap(results.begin(), results.end(), result_less);
+                }
+
+                if (results.size() == limit) radius = results.front().score;
+            }
+
+            /* visit the children closest to the query first, so the radius shrinks faster */
+            next_children.clear();
+            for (const auto& [child_dist, child] : m_nodes[node].children) {
+                size_t diff = detail::abs_diff(child_dist, dist);
+                if (diff <= radius) next_children.emplace_back(diff, child);
+            }
+            std::sort(next_children.begin(), next_children.end(), std::greater<>());
+            stack.insert(stack.end(), next_children.begin(), next_children.end());
+        }
+
+        std::sort_heap(results.begin(), results.end(), result_less);
+        return results;
+    }
+
+    template <typename Sentence>
+    std::vector<process::ExtractResult<size_t>>
+    nearest(const Sentence& s, size_t limit, size_t max_dist = std::numeric_limits<size_t>::max()) const
+    {
+        return nearest(detail::to_begin(s), detail::to_end(s), limit, max_dist);
+    }
+
+private:
+    struct Node {
+        /* distance to the parent and index of the child */
+        std::vector<std::pair<size_t, size_t>> children;
+        size_t max_child_dist = 0;
+    };
+
+    static size_t cutoff(size_t max_dist, size_t max_child_dist)
+    {
+        if (std::numeric_limits<size_t>::max() - max_dist < max_child_dist)
+            return std::numeric_limits<size_t>::max();
+        return max_dist + max_child_dist;
+    }
+
+    static bool result_less(const process::ExtractResult<size_t>& a, const process::ExtractResult<size_t>& b)
+    {
+        return (a.score != b.score) ? a.score < b.score : a.index < b.index;
+    }
+
+    std::vector<std::vector<CharT>> m_strings;
+    std::vector<Node> m_nodes;
+};
+
+} // namespace rapidfuzz
@@ -0,0 +1,249 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/PatternMatchVector.hpp>
+#include <rapidfuzz/details/Range.hpp>
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/details/intrinsics.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/process.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rapidfuzz {
+
+/**
+ * @brief Trie over a set of strings, which finds all strings within a given uniform Levenshtein
+ * distance of a query
+ *
+ * @details
+ * Strings sharing a prefix share the columns of the Levenshtein matrix calculated for this prefix.
+ * So the query is searched by walking the trie and calculating a single column of the bit-parallel
+ * implementation per node, using the pattern match vector of the query. A subtree is skipped when
+ * no cell of the current column is <= max_dist, since no cell can become <= max_dist again in the
+ * following columns, or when the lengths of the strings in the subtree differ too much from the query.
+ * This is faster than comparing the query to each string when the strings share long prefixes,
+ * e.g. file paths, urls or product identifiers.
+ *
+ * @tparam CharT character type of the indexed strings
+ */
+template <typename CharT>
+class LevenshteinTrie {
+public:
+    LevenshteinTrie() : m_nodes(1), m_size(0)
+    {}
+
+    /**
+     * @brief adds a string to the trie
+     *
+     * @return index of the string, which is returned by search
+     */
+    template <typename InputIt>
+    size_t insert(InputIt first, InputIt last)
+    {
+        size_t len = static_cast<size_t>(std::distance(first, last));
+        size_t node = 0;
+        update_lengths(node, len);
+        for (; first != last; ++first) {
+            CharT ch = static_cast<CharT>(*first);
+            auto& children = m_nodes[node].children;
+            auto child = std::lower_bound(children.begin(), children.end(), ch,
+                                          [](const auto& c, CharT key) { return c.first < key; });
+            if (child == children.end() || child->first != ch) {
+                size_t new_node = m_nodes.size();
+                children.emplace(child, ch, new_node);
+                /* invalidates children */
+                m_nodes.emplace_back();
+                node = new_node;
+            }
+            else
+                node = child->second;
+
+            update_lengths(node, len);
+        }
+
+        m_nodes[node].indices.push_back(m_size);
+        return m_size++;
+    }
+
+    template <typename Sentence>
+    size_t insert(const Sentence& s)
+    {
+        return insert(detail::to_begin(s), detail::to_end(s));
+    }
+
+    /**
+     * @return number of strings in the trie
+     */
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief finds all strings with a uniform Levenshtein distance <= max_dist
+     *
+     * @return matches with their distance as score, sorted by distance and index
+     */
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>> search(InputIt first, InputIt last, size_t max_dist) const
+    {
+        return _search(detail::Range(first, last), max_dist);
+    }
+
+    template <typename Sentence>
+    std::vector<process::ExtractResult<size_t>> search(const Sentence& s, size_t max_dist) const
+    {
+        return _search(detail::Range(s), max_dist);
+    }
+
+private:
+    struct Node {
+        /* children sorted by their character */
+        std::vector<std::pair<CharT, size_t>> children;
+        /* indices of the strings ending in this node */
+        std::vector<size_t> indices;
+        /* length of the shortest / longest string in the subtree */
+        size_t min_len = std::numeric_limits<size_t>::max();
+        size_t max_len = 0;
+    };
+
+    void update_lengths(size_t node, size_t len)
+    {
+        m_nodes[node].min_len = std::min(m_nodes[node].min_len, len);
+        m_nodes[node].max_len = std::max(m_nodes[node].max_len, len);
+    }
+
+    /**
+     * @brief last row of a column of the Levenshtein matrix with a distance <= max_dist
+     *
+     * @details
+     * Since the distances on a diagonal never decrease, only the rows up to the last active row of
+     * the previous column + 1 can be active (Ukkonen 1985). The search moves up from this row using
+     * the vertical differences stored in the bit rows.
+     *
+     * @return last active row + 1 or 0 when no row is active
+     */
+    static size_t last_active_row(const detail::LevenshteinRow* column, size_t depth, size_t start_row,
+                                  size_t max_dist)
+    {
+        /* distance in start_row */
+        ptrdiff_t dist = static_cast<ptrdiff_t>(depth);
+        size_t word = 0;
+        for (; (word + 1) * 64 <= start_row; ++word) {
+            dist += static_cast<ptrdiff_t>(detail::popcount(column[word].VP));
+            dist -= static_cast<ptrdiff_t>(detail::popcount(column[word].VN));
+        }
+        if (start_row % 64) {
+            uint64_t mask = (UINT64_C(1) << (start_row % 64)) - 1;
+            dist += static_cast<ptrdiff_t>(detail::popcount(column[word].VP & mask));
+            dist -= static_cast<ptrdiff_t>(detail::popcount(column[word].VN & mask));
+        }
+
+        size_t row = start_row;
+        while (row > 0 && static_cast<size_t>(dist) > max_dist) {
+            const auto& vecs = column[(row - 1) / 64];
+            size_t first_row = (row - 1) / 64 * 64;
+            uint64_t mask = ~UINT64_C(0) >> (63 - (row - 1) % 64);
+
+            /* moving up, the distance decreases at most once per set bit in VP, so all rows of the
+             * block up to this row can be skipped at once */
+            ptrdiff_t decrease = static_cast<ptrdiff_t>(detail::popcount(vecs.VP & mask));
+            if (dist - decrease > 0 && static_cast<size_t>(dist - decrease) > max_dist) {
+                dist -= decrease;
+                dist += static_cast<ptrdiff_t>(detail::popcount(vecs.VN & mask));
+                row = first_row;
+                continue;
+            }
+
+            for (; row > first_row && static_cast<size_t>(dist) > max_dist; --row) {
+                uint64_t bit = UINT64_C(1) << ((row - 1) % 64);
+                dist -= bool(vecs.VP & bit);
+                dist += bool(vecs.VN & bit);
+            }
+        }
+
+        return (static_cast<size_t>(dist) <= max_dist) ? row + 1 : 0;
+    }
+
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>> _search(const detail::Range<InputIt>& s1,
+                                                        size_t max_dist) const
+    {
+        std::vector<process::ExtractResult<size_t>> results;
+        size_t len1 = s1.size();
+        detail::BlockPatternMatchVector PM(s1);
+        size_t words = PM.size();
+
+        /* column of the Levenshtein matrix, distance in the last row and last active row + 1 for each
+         * depth of the current path. Nodes are visited depth first, so the parent column is still valid */
+        std::vector<detail::LevenshteinRow> columns(words);
+        std::vector<size_t> dists = {len1};
+        std::vector<size_t> active_rows = {std::min(len1, max_dist) + 1};
+
+        /* the subtree contains a string with a length difference <= max_dist to the query */
+        auto in_length_range = [&](const Node& node) {
+            return (node.min_len <= len1 || node.min_len - len1 <= max_dist) &&
+                   (node.max_len >= len1 || len1 - node.max_len <= max_dist);
+        };
+
+        struct Visit {
+            size_t node;
+            size_t depth;
+            CharT ch;
+        };
+
+        std::vector<Visit> stack;
+        if (m_size != 0) stack.push_back({0, 0, CharT()});
+
+        while (!stack.empty()) {
+            Visit visit = stack.back();
+            stack.pop_back();
+
+            if (visit.depth != 0) {
+                if (dists.size() <= visit.depth) {
+                    dists.resize(visit.depth + 1);
+                    active_rows.resize(visit.depth + 1);
+                    columns.resize((visit.depth + 1) * words);
+                }
+
+                detail::LevenshteinRow* column = columns.data() + visit.depth * words;
+                int delta = detail::levenshtein_hyrroe2003_column(PM, len1, column - words, column, visit.ch);
+                dists[visit.depth] =
+                    static_cast<size_t>(static_cast<ptrdiff_t>(dists[visit.depth - 1]) + delta);
+
+                /* no row can become active again in the following columns */
+                size_t start_row = std::min(len1, active_rows[visit.depth - 1]);
+                active_rows[visit.depth] = last_active_row(column, visit.depth, start_row, max_dist);
+                if (active_rows[visit.depth] == 0) continue;
+            }
+
+            /* most nodes are skipped before accessing them, which avoids cache misses */
+            const Node& node = m_nodes[visit.node];
+            if (!in_length_range(node)) continue;
+
+            if (dists[visit.depth] <= max_dist)
+                for (size_t index : node.indices)
+                    results.push_back({dists[visit.depth], index});
+
+            for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+                stack.push_back({child->second, visit.depth + 1, child->first});
+        }
+
+        std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+            return (a.score != b.score) ? a.score < b.score : a.index < b.index;
+        });
+        return results;
+    }
+
+    std::vector<Node> m_nodes;
+    size_t m_size;
+};
+
+} // namespace rapidfuzz
@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/Range.hpp>
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/process.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace rapidfuzz {
+
+/**
+ * @brief Inverted index over the positional q-grams of a set of strings, which finds
+ * all strings within a given uniform Levenshtein distance of a query
+ *
+ * @details
+ * A string of length n has n - q + 1 q-grams and each edit operation destroys at most q
+ * of them. So two strings within a distance of k share at least
+ * `max(len1, len2) - q + 1 - k * q` q-grams (count filter) and the positions of the shared
+ * q-grams differ by at most k (position filter). Only strings passing both filters are
+ * verified using the bit-parallel Levenshtein implementation. When the count filter can not
+ * reject any string (short strings or large k), all strings of a matching length are verified.
+ *
+ * @tparam CharT character type of the indexed strings
+ */
+template <typename CharT>
+class QGramIndex {
+public:
+    /**
+     * @param q length of the q-grams. Longer q-grams lead to shorter posting lists, but
+     *   the count filter becomes ineffective for larger distances.
+     */
+    explicit QGramIndex(size_t q = 3) : m_q(q)
+    {
+        if (m_q == 0) throw std::invalid_argument("q has to be > 0");
+    }
+
+    /**
+     * @brief adds a string to the index
+     *
+     * @return index of the string, which is returned by search
+     */
+    template <typename InputIt>
+    size_t insert(InputIt first, InputIt last)
+    {
+        size_t index = m_strings.size();
+        m_strings.emplace_back(first, last);
+        const auto& s = m_strings.back();
+
+        if (s.size() >= m_q)
+            for (size_t pos = 0; pos <= s.size() - m_q; ++pos)
+                m_postings[qgram_key(s.begin() + static_cast<ptrdiff_t>(pos))].push_back({index, pos});
+
+        m_length_buckets[s.size()].push_back(index);
+        return index;
+    }
+
+    template <typename Sentence>
+    size_t insert(const Sentence& s)
+    {
+        return insert(detail::to_begin(s), detail::to_end(s));
+    }
+
+    /**
+     * @return number of strings in the index
+     */
+    size_t size() const noexcept
+    {
+        return m_strings.size();
+    }
+
+    size_t q() const noexcept
+    {
+        return m_q;
+    }
+
+    /**
+     * @brief finds all strings with a uniform Levenshtein distance <= max_dist
+     *
+     * @return matches with their distance as score, sorted by distance and index
+     */
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>> search(InputIt first, InputIt last, size_t max_dist) const
+    {
+        return _search(detail::Range(first, last), max_dist);
+    }
+
+    template <typename Sentence>
+    std::vector<process::ExtractResult<size_t>> search(const Sentence& s, size_t max_dist) const
+    {
+        return _search(detail::Range(s), max_dist);
+    }
+
+private:
+    struct Posting {
+        size_t index;
+        size_t pos;
+    };
+
+    template <typename InputIt>
+    uint64_t qgram_key(InputIt first) const
+    {
+        /* FNV-1a style hash. Collisions only lead to additional candidates */
+        uint64_t key = UINT64_C(14695981039346656037);
+        for (size_t i = 0; i < m_q; ++i, ++first) {
+            key ^= static_cast<uint64_t>(*first);
+            key *= UINT64_C(1099511628211);
+        }
+        return key;
+    }
+
+    /* number of q-grams two strings within a distance of max_dist share at least */
+    size_t min_common_qgrams(size_t len1, size_t len2, size_t max_dist) const
+    {
+        size_t qgrams = std::max(len1, len2) + 1;
+        if (qgrams <= m_q || max_dist >= qgrams / m_q) return 0;
+
+        qgrams -= m_q;
+        size_t destroyed = max_dist * m_q;
+        return (qgrams > destroyed) ? qgrams - destroyed : 0;
+    }
+
+    template <typename InputIt>
+    std::vector<process::ExtractResult<size_t>> _search(const detail::Range<InputIt>& s1,
+                                                        size_t max_dist) const
+    {
+        size_t len1 = s1.size();
+        size_t min_len = (len1 > max_dist) ? len1 - max_dist : 0;
+        size_t max_len = (std::numeric_limits<size_t>::max() - len1 > max_dist)
+                             ? len1 + max_dist
+                             : std::numeric_limits<size_t>::max();
+
+        std::vector<size_t> candidates;
+        /* lengths for which the count filter can not reject any string */
+        for (auto it = m_length_buckets.lower_bound(min_len); it != m_length_buckets.end(); ++it) {
+            if (it->first > max_len) break;
+            if (min_common_qgrams(len1, it->first, max_dist) == 0)
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+
+        std::unordered_map<size_t, size_t> common_qgrams;
+        if (len1 >= m_q) {
+            for (size_t pos1 = 0; pos1 <= len1 - m_q; ++pos1) {
+                auto postings = m_postings.find(qgram_key(s1.begin() + static_cast<ptrdiff_t>(pos1)));
+                if (postings == m_postings.end()) continue;
+
+                for (const auto& posting : postings->second) {
+                    size_t len2 = m_strings[posting.index].size();
+                    if (len2 < min_len || len2 > max_len) continue;
+                    if (detail::abs_diff(posting.pos, pos1) > max_dist) continue;
+
+                    common_qgrams[posting.index]++;
+                }
+            }
+        }
+
+        for (const auto& [index, count] : common_qgrams) {
+            size_t min_common = min_common_qgrams(len1, m_strings[index].size(), max_dist);
+            if (min_common != 0 && count >= min_common) candidates.push_back(index);
+        }
+
+        std::vector<process::ExtractResult<size_t>> results;
+        if (candidates.empty()) return results;
+
+        detail::BlockPatternMatchVector PM(s1);
+        for (size_t index : candidates) {
+            size_t dist = detail::uniform_levenshtein_distance(PM, s1, detail::Range(m_strings[index]),
+                                                               max_dist, max_dist);
+            if (dist <= max_dist) results.push_back({dist, index});
+        }
+
+        std::sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+            return (a.score != b.score) ? a.score < b.score : a.index < b.index;
+        });
+        return results;
+    }
+
+    size_t m_q;
+    std::vector<std::vector<CharT>> m_strings;
+    std::unordered_map<uint64_t, std::vector<Posting>> m_postings;
+    std::map<size_t, std::vector<size_t>> m_length_buckets;
+};
+
+} // namespace rapidfuzz
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#pragma once
+#include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace rapidfuzz::process {
+
+/**
+ * @defgroup Process Process
+ * Batch helpers to compare a single query with a large list of choices
+ * @{
+ */
+
+/**
+ * @brief selects the member function of the cached scorer, which is used
+ * to score the choices and whether higher or lower scores are better
+ */
+enum class ScoreKind {
+    Similarity,           /**< `similarity`, higher is better */
+    Distance,             /**< `distance`, lower is better */
+    NormalizedSimilarity, /**< `normalized_similarity`, higher is better */
+    NormalizedDistance    /**< `normalized_distance`, lower is better */
+};
+
+template <typename ScoreT>
+struct ExtractResult {
+    ScoreT score;
+    size_t index;
+
+    friend bool operator==(const ExtractResult& a, const ExtractResult& b)
+    {
+        return a.score == b.score && a.index == b.index;
+    }
+
+    friend bool operator!=(const ExtractResult& a, const ExtractResult& b)
+    {
+        return !(a == b);
+    }
+};
+
+namespace process_detail {
+
+template <ScoreKind Kind>
+struct ScoreKindImpl;
+
+template <typename T>
+struct type_identity {
+    using type = T;
+};
+
+template <typename T>
+using type_identity_t = typename type_identity<T>::type;
+
+template <typename Choices>
+using choice_t = std::decay_t<decltype(*std::begin(std::declval<const Choices&>()))>;
+
+template <ScoreKind Kind, typename CachedScorer, typename Choices>
+using score_t = std::decay_t<decltype(ScoreKindImpl<Kind>::call(std::declval<const CachedScorer&>(),
+                                                                std::declval<const choice_t<Choices>&>()))>;
+
+template <template <typename> class CachedScorer, ScoreKind Kind, typename Queries, typename Choices>
+using cdist_score_t = score_t<Kind, CachedScorer<char_type<choice_t<Queries>>>, Choices>;
+
+} // namespace process_detail
+
+/**
+ * @brief Finds the best matches for a query in a list of choices
+ *
+ * @details
+ * The query is passed in the form of a cached scorer (e.g. `fuzz::CachedRatio`
+ * or `CachedLevenshtein`), so the preprocessing of the query is only performed once.
+ * Only the best `limit` results are kept. As soon as `limit` results are found, the
+ * score of the worst of them is used as `score_cutoff` for all following choices,
+ * which allows the scorers to exit early for choices which could not make it into
+ * the result.
+ *
+ * @tparam Kind score of the cached scorer used to compare the choices
+ *
+ * @param scorer
+ *   cached scorer constructed from the query
+ * @param choices
+ *   range of choices which can be passed to the scorer
+ * @param limit
+ *   maximum number of results to return
+ * @param score_cutoff
+ *   Optional argument for a score threshold. Choices with a worse score are
+ *   not part of the result. Default is the worst possible score, which
+ *   deactivates this behaviour.
+ *
+ * @return the best results sorted by score. Results with the same score are
+ *   sorted by their index in choices.
+ */
+template <ScoreKind Kind = ScoreKind::Similarity, typename CachedScorer, typename Choices,
+          typename ScoreT = process_detail::score_t<Kind, CachedScorer, Choices>>
+std::vector<ExtractResult<ScoreT>>
+extract(const CachedScorer& scorer, const Choices& choices, size_t limit,
+        process_detail::type_identity_t<ScoreT> score_cutoff =
+            process_detail::ScoreKindImpl<Kind>::template worst_score<ScoreT>());
+
+/**
+ * @brief Finds the best match for a query in a list of choices
+ *
+ * @details
+ * Behaves like `extract` with a limit of 1. The score of the best match found so
+ * far is used as `score_cutoff` for all following choices.
+ *
+ * @return the best result or std::nullopt when no choice reached the score_cutoff.
+ *   When multiple choices have the same score, the first one is returned.
+ */
+template <ScoreKind Kind = ScoreKind::Similarity, typename CachedScorer, typename Choices,
+          typename ScoreT = process_detail::score_t<Kind, CachedScorer, Choices>>
+std::optional<ExtractResult<ScoreT>>
+extractOne(const CachedScorer& scorer, const Choices& choices,
+           process_detail::type_identity_t<ScoreT> score_cutoff =
+               process_detail::ScoreKindImpl<Kind>::template worst_score<ScoreT>());
+
+/**
+ * @brief Calculates the score for every combination of queries and choices
+ *
+ * @details
+ * The matrix is split into tiles, which are distributed over the worker threads. Threads
+ * fetch the next tile as soon as they are done with their current one, so tiles with
+ * longer strings do not leave the other workers idle. Inside a tile the cached scorer of
+ * each query is only constructed once. For scorers with an experimental SIMD
+ * implementation (`CachedLevenshtein` with uniform weights and `CachedIndel`) the choices
+ * of a tile are packed into a `MultiLevenshtein` / `MultiIndel` when all of them are
+ * shorter than 65 characters.
+ *
+ * @tparam CachedScorer cached scorer template used to compare the strings, e.g. CachedLevenshtein
+ * @tparam Kind score of the cached scorer used to compare the strings
+ *
+ * @param queries
+ *   random access range of queries
+ * @param choices
+ *   random access range of choices
+ * @param workers
+ *   number of threads used. 0 uses `std::thread::hardware_concurrency()`
+ * @param score_cutoff
+ *   Optional argument for a score threshold, which is passed to the scorer.
+ *   Default is the worst possible score, which deactivates this behaviour.
+ * @param args
+ *   additional arguments passed to the constructor of the cached scorer
+ *
+ * @return row-major matrix of size `queries.size() * choices.size()` where
+ *   `result[i * choices.size() + j]` is the score of `queries[i]` and `choices[j]`
+ */
+template <template <typename> class CachedScorer, ScoreKind Kind = ScoreKind::Similarity, typename Queries,
+          typename Choices,
+          typename ScoreT = process_detail::cdist_score_t<CachedScorer, Kind, Queries, Choices>,
+          typename... Args>
+std::vector<ScoreT> cdist(const Queries& queries, const Choices& choices, size_t workers = 1,
+                          process_detail::type_identity_t<ScoreT> score_cutoff =
+                              process_detail::ScoreKindImpl<Kind>::template worst_score<ScoreT>(),
+                          const Args&... args);
+
+/**@}*/
+
+} // namespace rapidfuzz::process
+
+#include <rapidfuzz/process_impl.hpp>
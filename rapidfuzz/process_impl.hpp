@@ -0,0 +1,437 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace rapidfuzz::process {
+
+namespace process_detail {
+
+template <>
+struct ScoreKindImpl<ScoreKind::Similarity> {
+    template <typename CachedScorer, typename Sentence2, typename... Args>
+    static auto call(const CachedScorer& scorer, const Sentence2& s2, Args... score_cutoff)
+    {
+        return scorer.similarity(s2, score_cutoff...);
+    }
+
+    template <typename ScoreT>
+    static constexpr ScoreT worst_score()
+    {
+        return ScoreT(0);
+    }
+
+    static constexpr bool higher_is_better = true;
+};
+
+template <>
+struct ScoreKindImpl<ScoreKind::Distance> {
+    template <typename CachedScorer, typename Sentence2, typename... Args>
+    static auto call(const CachedScorer& scorer, const Sentence2& s2, Args... score_cutoff)
+    {
+        return scorer.distance(s2, score_cutoff...);
+    }
+
+    template <typename ScoreT>
+    static constexpr ScoreT worst_score()
+    {
+        return std::numeric_limits<ScoreT>::max();
+    }
+
+    static constexpr bool higher_is_better = false;
+};
+
+template <>
+struct ScoreKindImpl<ScoreKind::NormalizedSimilarity> {
+    template <typename CachedScorer, typename Sentence2, typename... Args>
+    static auto call(const CachedScorer& scorer, const Sentence2& s2, Args... score_cutoff)
+    {
+        return scorer.normalized_similarity(s2, score_cutoff...);
+    }
+
+    template <typename ScoreT>
+    static constexpr ScoreT worst_score()
+    {
+        return ScoreT(0);
+    }
+
+    static constexpr bool higher_is_better = true;
+};
+
+template <>
+struct ScoreKindImpl<ScoreKind::NormalizedDistance> {
+    template <typename CachedScorer, typename Sentence2, typename... Args>
+    static auto call(const CachedScorer& scorer, const Sentence2& s2, Args... score_cutoff)
+    {
+        return scorer.normalized_distance(s2, score_cutoff...);
+    }
+
+    template <typename ScoreT>
+    static constexpr ScoreT worst_score()
+    {
+        return ScoreT(1);
+    }
+
+    static constexpr bool higher_is_better = false;
+};
+
+/*
+ * helpers to compare scores independent of the orientation of the scorer
+ */
+template <ScoreKind Kind, typename ScoreT>
+struct ScoreCompare {
+    static constexpr bool higher_is_better = ScoreKindImpl<Kind>::higher_is_better;
+
+    /* score reaches the score_cutoff */
+    static bool passes(ScoreT score, ScoreT score_cutoff)
+    {
+        if constexpr (higher_is_better)
+            return score >= score_cutoff;
+        else
+            return score <= score_cutoff;
+    }
+
+    static bool is_better(ScoreT a, ScoreT b)
+    {
+        if constexpr (higher_is_better)
+            return a > b;
+        else
+            return a < b;
+    }
+
+    static bool is_better(const ExtractResult<ScoreT>& a, const ExtractResult<ScoreT>& b)
+    {
+        if (a.score == b.score) return a.index < b.index;
+        return is_better(a.score, b.score);
+    }
+
+    /* perfect score, so no later choice can beat it */
+    static bool is_optimal(ScoreT score)
+    {
+        if constexpr (Kind == ScoreKind::NormalizedSimilarity)
+            return score == ScoreT(1);
+        else if constexpr (higher_is_better)
+            return false;
+        else
+            return score == ScoreT(0);
+    }
+
+    /*
+     * score_cutoff used once the result is full. Choices are only added when they are strictly
+     * better than the worst result, since on a tie the choice with the lower index wins. For
+     * integral scores this allows moving the score_cutoff one step further.
+     */
+    static ScoreT next_cutoff(ScoreT worst)
+    {
+        if constexpr (!std::is_integral_v<ScoreT>)
+            return worst;
+        else if constexpr (higher_is_better)
+            return (worst < std::numeric_limits<ScoreT>::max()) ? worst + 1 : worst;
+        else
+            return (worst > 0) ? worst - 1 : worst;
+    }
+};
+
+/*
+ * Maps a cached scorer to the experimental SIMD scorer comparing one string with
+ * multiple strings at once
+ */
+template <template <typename> class CachedScorer>
+struct MultiScorerFor {
+    static constexpr bool available = false;
+};
+
+#ifdef RAPIDFUZZ_SIMD
+template <>
+struct MultiScorerFor<CachedLevenshtein> {
+    static constexpr bool available = true;
+
+    template <int MaxLen>
+    using type = experimental::MultiLevenshtein<MaxLen>;
+
+    static bool supported(LevenshteinWeightTable weights = {1, 1, 1})
+    {
+        return weights.insert_cost == 1 && weights.delete_cost == 1 && weights.replace_cost == 1;
+    }
+};
+
+template <>
+struct MultiScorerFor<CachedIndel> {
+    static constexpr bool available = true;
+
+    template <int MaxLen>
+    using type = experimental::MultiIndel<MaxLen>;
+
+    static bool supported()
+    {
+        return true;
+    }
+};
+#endif
+
+/* tile size used with the cached scorers */
+constexpr size_t cdist_tile_rows = 16;
+constexpr size_t cdist_tile_cols = 1024;
+/* number of queries per tile when the choices are packed into a SIMD scorer */
+constexpr size_t cdist_multi_tile_rows = 32;
+
+/*
+ * Runs func(task) for task in [0, task_count) on the given amount of threads. Tasks are
+ * handed out through a shared counter, so a thread fetches a new task as soon as it finished
+ * the previous one. The first exception thrown by any task is rethrown in the calling thread.
+ */
+template <typename Func>
+void run_parallel(size_t task_count, size_t workers, Func&& func)
+{
+    if (workers == 0) workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    workers = std::min(workers, task_count);
+
+    if (workers <= 1) {
+        for (size_t task = 0; task < task_count; ++task)
+            func(task);
+        return;
+    }
+
+    std::atomic<size_t> next_task{0};
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]() {
+        try {
+            for (size_t task = next_task++; task < task_count; task = next_task++)
+                func(task);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (!exception) exception = std::current_exception();
+            next_task = task_count;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t i = 0; i < workers - 1; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (exception) std::rethrow_exception(exception);
+}
+
+template <typename Container>
+size_t range_size(const Container& range)
+{
+    return static_cast<size_t>(std::distance(std::begin(range), std::end(range)));
+}
+
+template <typename Container>
+decltype(auto) range_at(const Container& range, size_t pos)
+{
+    return std::begin(range)[static_cast<ptrdiff_t>(pos)];
+}
+
+template <template <typename> class CachedScorer, ScoreKind Kind, typename ScoreT, typename Queries,
+          typename Choices, typename... Args>
+void cdist_cached(ScoreT* result, const Queries& queries, const Choices& choices, size_t workers,
+                  ScoreT score_cutoff, const Args&... args)
+{
+    using Query = choice_t<Queries>;
+    size_t query_count = range_size(queries);
+    size_t choice_count = range_size(choices);
+    size_t row_tiles = detail::ceil_div(query_count, cdist_tile_rows);
+    size_t col_tiles = detail::ceil_div(choice_count, cdist_tile_cols);
+
+    run_parallel(row_tiles * col_tiles, workers, [&](size_t tile) {
+        size_t row_first = (tile / col_tiles) * cdist_tile_rows;
+        size_t row_last = std::min(row_first + cdist_tile_rows, query_count);
+        size_t col_first = (tile % col_tiles) * cdist_tile_cols;
+        size_t col_last = std::min(col_first + cdist_tile_cols, choice_count);
+
+        for (size_t row = row_first; row < row_last; ++row) {
+            CachedScorer<char_type<Query>> scorer(range_at(queries, row), args...);
+            ScoreT* result_row = result + row * choice_count;
+            for (size_t col = col_first; col < col_last; ++col)
+                result_row[col] = static_cast<ScoreT>(
+                    ScoreKindImpl<Kind>::call(scorer, range_at(choices, col), score_cutoff));
+        }
+    });
+}
+
+#ifdef RAPIDFUZZ_SIMD
+template <typename MultiScorer, ScoreKind Kind, typename ScoreT, typename Sentence2, typename ResType>
+void multi_scorer_call(const MultiScorer& scorer, ResType* scores, size_t score_count, const Sentence2& s2,
+                       ScoreT score_cutoff)
+{
+    if constexpr (Kind == ScoreKind::Similarity)
+        scorer.similarity(scores, score_count, s2, score_cutoff);
+    else if constexpr (Kind == ScoreKind::Distance)
+        scorer.distance(scores, score_count, s2, score_cutoff);
+    else if constexpr (Kind == ScoreKind::NormalizedSimilarity)
+        scorer.normalized_similarity(scores, score_count, s2, score_cutoff);
+    else
+        scorer.normalized_distance(scores, score_count, s2, score_cutoff);
+}
+
+/*
+ * The choices of a tile are packed into a single SIMD scorer, which is used to compare them
+ * with each query of the tile. This relies on the scorer being symmetric.
+ */
+template <typename MultiScorer, ScoreKind Kind, typename ScoreT, typename Queries, typename Choices>
+void cdist_multi(ScoreT* result, const Queries& queries, const Choices& choices, size_t workers,
+                 ScoreT score_cutoff, size_t tile_cols)
+{
+    using ResType = std::conditional_t<Kind == ScoreKind::Similarity || Kind == ScoreKind::Distance, size_t,
+                                       double>;
+    size_t query_count = range_size(queries);
+    size_t choice_count = range_size(choices);
+    size_t row_tiles = detail::ceil_div(query_count, cdist_multi_tile_rows);
+    size_t col_tiles = detail::ceil_div(choice_count, tile_cols);
+
+    run_parallel(row_tiles * col_tiles, workers, [&](size_t tile) {
+        size_t row_first = (tile / col_tiles) * cdist_multi_tile_rows;
+        size_t row_last = std::min(row_first + cdist_multi_tile_rows, query_count);
+        size_t col_first = (tile % col_tiles) * tile_cols;
+        size_t col_last = std::min(col_first + tile_cols, choice_count);
+
+        MultiScorer scorer(col_last - col_first);
+        for (size_t col = col_first; col < col_last; ++col)
+            scorer.insert(range_at(choices, col));
+
+        std::vector<ResType> scores(scorer.result_count());
+        for (size_t row = row_first; row < row_last; ++row) {
+            multi_scorer_call<MultiScorer, Kind>(scorer, scores.data(), scores.size(), range_at(queries, row),
+                                                 score_cutoff);
+            ScoreT* result_row = result + row * choice_count;
+            for (size_t col = col_first; col < col_last; ++col)
+                result_row[col] = static_cast<ScoreT>(scores[col - col_first]);
+        }
+    });
+}
+
+template <typename MultiScorerTraits, ScoreKind Kind, typename ScoreT, typename Queries, typename Choices>
+bool cdist_try_multi(ScoreT* result, const Queries& queries, const Choices& choices, size_t workers,
+                     ScoreT score_cutoff)
+{
+    size_t max_len = 0;
+    for (const auto& choice : choices)
+        max_len = std::max(max_len, static_cast<size_t>(std::distance(detail::to_begin(choice),
+                                                                      detail::to_end(choice))));
+
+    /* the SIMD scorers store 4096 bits per tile, which keeps the pattern match vector small */
+    if (max_len <= 8)
+        cdist_multi<typename MultiScorerTraits::template type<8>, Kind>(result, queries, choices, workers,
+                                                                       score_cutoff, 4096 / 8);
+    else if (max_len <= 16)
+        cdist_multi<typename MultiScorerTraits::template type<16>, Kind>(result, queries, choices, workers,
+                                                                        score_cutoff, 4096 / 16);
+    else if (max_len <= 32)
+        cdist_multi<typename MultiScorerTraits::template type<32>, Kind>(result, queries, choices, workers,
+                                                                        score_cutoff, 4096 / 32);
+    else if (max_len <= 64)
+        cdist_multi<typename MultiScorerTraits::template type<64>, Kind>(result, queries, choices, workers,
+                                                                        score_cutoff, 4096 / 64);
+    else
+        return false;
+
+    return true;
+}
+#endif
+
+} // namespace process_detail
+
+template <ScoreKind Kind, typename CachedScorer, typename Choices, typename ScoreT>
+std::vector<ExtractResult<ScoreT>> extract(const CachedScorer& scorer, const Choices& choices, size_t limit,
+                                           process_detail::type_identity_t<ScoreT> score_cutoff)
+{
+    using Impl = process_detail::ScoreKindImpl<Kind>;
+    using Compare = process_detail::ScoreCompare<Kind, ScoreT>;
+
+    std::vector<ExtractResult<ScoreT>> results;
+    if (limit == 0) return results;
+
+    /* heap ordered so the worst result is at the front */
+    auto heap_cmp = [](const ExtractResult<ScoreT>& a, const ExtractResult<ScoreT>& b) {
+        return Compare::is_better(a, b);
+    };
+
+    size_t index = 0;
+    for (const auto& choice : choices) {
+        ScoreT score = static_cast<ScoreT>(Impl::call(scorer, choice, score_cutoff));
+        if (Compare::passes(score, score_cutoff)) {
+            if (results.size() < limit) {
+                results.push_back({score, index});
+                std::push_heap(results.begin(), results.end(), heap_cmp);
+            }
+            else if (Compare::is_better(score, results.front().score)) {
+                std::pop_heap(results.begin(), results.end(), heap_cmp);
+                results.back() = {score, index};
+                std::push_heap(results.begin(), results.end(), heap_cmp);
+            }
+
+            if (results.size() == limit) {
+                ScoreT worst = results.front().score;
+                if (Compare::is_optimal(worst)) break;
+                score_cutoff = Compare::next_cutoff(worst);
+            }
+        }
+        index++;
+    }
+
+    std::sort_heap(results.begin(), results.end(), heap_cmp);
+    return results;
+}
+
+template <ScoreKind Kind, typename CachedScorer, typename Choices, typename ScoreT>
+std::optional<ExtractResult<ScoreT>> extractOne(const CachedScorer& scorer, const Choices& choices,
+                                                process_detail::type_identity_t<ScoreT> score_cutoff)
+{
+    using Impl = process_detail::ScoreKindImpl<Kind>;
+    using Compare = process_detail::ScoreCompare<Kind, ScoreT>;
+
+    std::optional<ExtractResult<ScoreT>> result;
+
+    size_t index = 0;
+    for (const auto& choice : choices) {
+        ScoreT score = static_cast<ScoreT>(Impl::call(scorer, choice, score_cutoff));
+        if (Compare::passes(score, score_cutoff) && (!result || Compare::is_better(score, result->score))) {
+            result = ExtractResult<ScoreT>{score, index};
+            if (Compare::is_optimal(score)) break;
+            score_cutoff = Compare::next_cutoff(score);
+        }
+        index++;
+    }
+
+    return result;
+}
+
+template <template <typename> class CachedScorer, ScoreKind Kind, typename Queries, typename Choices,
+          typename ScoreT, typename... Args>
+std::vector<ScoreT> cdist(const Queries& queries, const Choices& choices, size_t workers,
+                          process_detail::type_identity_t<ScoreT> score_cutoff, const Args&... args)
+{
+    std::vector<ScoreT> result(process_detail::range_size(queries) * process_detail::range_size(choices));
+    if (result.empty()) return result;
+
+#ifdef RAPIDFUZZ_SIMD
+    using MultiScorerTraits = process_detail::MultiScorerFor<CachedScorer>;
+    if constexpr (MultiScorerTraits::available) {
+        if (MultiScorerTraits::supported(args...) &&
+            process_detail::cdist_try_multi<MultiScorerTraits, Kind>(result.data(), queries, choices, workers,
+                                                                     score_cutoff))
+            return result;
+    }
+#endif
+
+    process_detail::cdist_cached<CachedScorer, Kind>(result.data(), queries, choices, workers, score_cutoff,
+                                                     args...);
+    return result;
+}
+
+} // namespace rapidfuzz::process
@@ -3,4 +3,6 @@
 
 #pragma once
 #include <rapidfuzz/distance.hpp>
-#include <rapidfuzz/fuzz.hpp>
\ No newline at end of file
+#include <rapidfuzz/fuzz.hpp>
+#include <rapidfuzz/index.hpp>
+#include <rapidfuzz/process.hpp>
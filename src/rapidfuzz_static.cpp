@@ -0,0 +1,7 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright © 2022-present Max Bachmann */
+
+/* explicit instantiations of the algorithms precompiled in the rapidfuzz_static library */
+#include <rapidfuzz/details/instantiations.hpp>
+
+RAPIDFUZZ_INSTANTIATE()
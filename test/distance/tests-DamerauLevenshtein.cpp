@@ -2,7 +2,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/types.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <rapidfuzz/distance/DamerauLevenshtein.hpp>
 
@@ -21,6 +25,35 @@ size_t damerau_levenshtein_distance(const Sentence1& s1, const Sentence2& s2,
     rapidfuzz::experimental::CachedDamerauLevenshtein scorer(s1);
     size_t res4 = scorer.distance(s2, max);
     size_t res5 = scorer.distance(s2.begin(), s2.end(), max);
+#ifdef RAPIDFUZZ_SIMD
+    if (s1.size() <= 64) {
+        std::vector<size_t> results(512 / 8);
+        if (s1.size() <= 8) {
+            rapidfuzz::experimental::MultiDamerauLevenshtein<8> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 16) {
+            rapidfuzz::experimental::MultiDamerauLevenshtein<16> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 32) {
+            rapidfuzz::experimental::MultiDamerauLevenshtein<32> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 64) {
+            rapidfuzz::experimental::MultiDamerauLevenshtein<64> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+    }
+#endif
     REQUIRE(res1 == res2);
     REQUIRE(res1 == res3);
     REQUIRE(res1 == res4);
@@ -130,3 +163,141 @@ TEST_CASE("Levenshtein")
         }
     }
 }
+
+/* unrestricted Damerau-Levenshtein distance from Lowrance and Wagner */
+static size_t damerau_levenshtein_reference(const std::string& s1, const std::string& s2)
+{
+    size_t len1 = s1.size();
+    size_t len2 = s2.size();
+    size_t max_dist = len1 + len2;
+    std::vector<std::vector<size_t>> d(len1 + 2, std::vector<size_t>(len2 + 2, 0));
+    std::map<char, size_t> last_row;
+
+    d[0][0] = max_dist;
+    for (size_t i = 0; i <= len1; ++i) {
+        d[i + 1][0] = max_dist;
+        d[i + 1][1] = i;
+    }
+    for (size_t j = 0; j <= len2; ++j) {
+        d[0][j + 1] = max_dist;
+        d[1][j + 1] = j;
+    }
+
+    for (size_t i = 1; i <= len1; ++i) {
+        size_t last_col = 0;
+        for (size_t j = 1; j <= len2; ++j) {
+            size_t k = last_row[s2[j - 1]];
+            size_t l = last_col;
+            size_t cost = 1;
+            if (s1[i - 1] == s2[j - 1]) {
+                cost = 0;
+                last_col = j;
+            }
+            d[i + 1][j + 1] = std::min({d[i][j] + cost, d[i + 1][j] + 1, d[i][j + 1] + 1,
+                                        d[k][l] + (i - k - 1) + 1 + (j - l - 1)});
+        }
+        last_row[s1[i - 1]] = i;
+    }
+    return d[len1 + 1][len2 + 1];
+}
+
+TEST_CASE("DamerauLevenshtein random")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+    std::uniform_int_distribution<int> edit_dist(0, 3);
+
+    auto random_string = [&](size_t len) {
+        std::string s(len, 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        return s;
+    };
+
+    /* applies random insertions, deletions, substitutions and transpositions */
+    auto edit = [&](std::string s, size_t edits) {
+        for (size_t i = 0; i < edits && !s.empty(); ++i) {
+            size_t pos = std::uniform_int_distribution<size_t>(0, s.size() - 1)(gen);
+            switch (edit_dist(gen)) {
+            case 0: s.insert(pos, 1, static_cast<char>(char_dist(gen))); break;
+            case 1: s.erase(pos, 1); break;
+            case 2: s[pos] = static_cast<char>(char_dist(gen)); break;
+            default:
+                if (pos + 1 < s.size()) std::swap(s[pos], s[pos + 1]);
+            }
+        }
+        return s;
+    };
+
+    for (size_t len : {1, 3, 10, 63, 64, 65, 150}) {
+        for (size_t edits : {1, 2, 4, 10, 40}) {
+            for (size_t i = 0; i < 10; ++i) {
+                std::string s1 = random_string(len);
+                std::string s2 = edit(s1, edits);
+                size_t expected = damerau_levenshtein_reference(s1, s2);
+                INFO("s1: " << s1 << " s2: " << s2);
+                REQUIRE(damerau_levenshtein_distance(s1, s2) == expected);
+                REQUIRE(damerau_levenshtein_distance(s2, s1) == expected);
+                for (size_t max : {size_t(0), size_t(1), size_t(2), size_t(3), expected / 2, expected - 1})
+                    REQUIRE(damerau_levenshtein_distance(s1, s2, max) ==
+                            ((expected <= max) ? expected : max + 1));
+            }
+        }
+    }
+}
+
+#ifdef RAPIDFUZZ_SIMD
+template <int MaxLen>
+static void test_multi_damerau_levenshtein(const std::vector<std::string>& strings, const std::string& s2)
+{
+    rapidfuzz::experimental::MultiDamerauLevenshtein<MaxLen> scorer(strings.size());
+    for (const auto& s1 : strings)
+        scorer.insert(s1);
+
+    std::vector<size_t> results(scorer.result_count());
+    for (size_t max : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(6), SIZE_MAX}) {
+        scorer.distance(&results[0], results.size(), s2, max);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            size_t expected = damerau_levenshtein_reference(strings[i], s2);
+            INFO("s1: " << strings[i] << " s2: " << s2 << " max: " << max);
+            REQUIRE(results[i] == ((expected <= max) ? expected : max + 1));
+        }
+    }
+}
+
+TEST_CASE("MultiDamerauLevenshtein")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+    auto random_string = [&](size_t len) {
+        std::string s(len, 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        return s;
+    };
+
+    for (size_t len2 : {0, 1, 5, 8, 20, 64, 100}) {
+        std::string s2 = random_string(len2);
+        std::vector<std::string> strings = {"", "ca", s2.substr(0, 8)};
+        /* strings with transpositions of s2, which are not handled by OSA */
+        for (size_t i = 0; i < 40; ++i) {
+            std::string s1 = s2.substr(0, std::min<size_t>(len2, 8 + i));
+            for (size_t j = 0; j < i % 4 && s1.size() > 3; ++j) {
+                std::uniform_int_distribution<size_t> pos_dist(0, s1.size() - 3);
+                size_t pos = pos_dist(gen);
+                std::swap(s1[pos], s1[pos + 1]);
+                s1.insert(pos + 1, 1, static_cast<char>(char_dist(gen)));
+            }
+            strings.push_back(s1.substr(0, 64));
+            strings.push_back(random_string(i % 9));
+        }
+
+        std::vector<std::string> short_strings;
+        for (const auto& s : strings)
+            if (s.size() <= 8) short_strings.push_back(s);
+
+        test_multi_damerau_levenshtein<8>(short_strings, s2);
+        test_multi_damerau_levenshtein<64>(strings, s2);
+    }
+}
+#endif
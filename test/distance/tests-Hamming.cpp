@@ -2,7 +2,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <rapidfuzz/distance.hpp>
 #include <rapidfuzz/distance/Hamming.hpp>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "../common.hpp"
 
@@ -18,6 +20,35 @@ size_t hamming_distance(const Sentence1& s1, const Sentence2& s2,
     rapidfuzz::CachedHamming scorer(s1);
     size_t res4 = scorer.distance(s2, max);
     size_t res5 = scorer.distance(s2.begin(), s2.end(), max);
+#ifdef RAPIDFUZZ_SIMD
+    if (s1.size() <= 64) {
+        std::vector<size_t> results(512 / 8);
+        if (s1.size() <= 8) {
+            rapidfuzz::experimental::MultiHamming<8> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 16) {
+            rapidfuzz::experimental::MultiHamming<16> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 32) {
+            rapidfuzz::experimental::MultiHamming<32> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+        if (s1.size() <= 64) {
+            rapidfuzz::experimental::MultiHamming<64> simd_scorer(1);
+            simd_scorer.insert(s1);
+            simd_scorer.distance(&results[0], results.size(), s2, max);
+            REQUIRE(res1 == results[0]);
+        }
+    }
+#endif
     REQUIRE(res1 == res2);
     REQUIRE(res1 == res3);
     REQUIRE(res1 == res4);
@@ -120,4 +151,140 @@ TEST_CASE("Hamming_editops")
         REQUIRE(ops.get_src_len() == d.size());
         REQUIRE(ops.get_dest_len() == s.size());
     }
-}
\ No newline at end of file
+}
+template <typename CharT>
+static void test_hamming_long_strings(std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> char_dist(0, 3);
+    /* characters which only differ in a single byte */
+    std::vector<CharT> alphabet = {CharT(0x41), CharT(0x42), CharT(~0x41), CharT(0x41 | (0x42 << 8))};
+
+    for (size_t len : {1, 15, 16, 31, 63, 64, 65, 127, 128, 200, 1000}) {
+        std::vector<CharT> s1(len, CharT(0x41));
+        for (auto& ch : s1)
+            ch = alphabet[static_cast<size_t>(char_dist(gen))];
+
+        for (size_t edits : {0, 1, 5, 50, 1000}) {
+            std::vector<CharT> s2 = s1;
+            for (size_t i = 0; i < edits; ++i)
+                s2[std::uniform_int_distribution<size_t>(0, len - 1)(gen)] =
+                    alphabet[static_cast<size_t>(char_dist(gen))];
+            if (edits == 50) s2.resize(len / 2);
+
+            size_t expected = std::max(s1.size(), s2.size());
+            rapidfuzz::Editops expected_ops;
+            expected_ops.set_src_len(s1.size());
+            expected_ops.set_dest_len(s2.size());
+            for (size_t i = 0; i < std::min(s1.size(), s2.size()); ++i) {
+                expected -= bool(s1[i] == s2[i]);
+                if (s1[i] != s2[i]) expected_ops.emplace_back(rapidfuzz::EditType::Replace, i, i);
+            }
+            for (size_t i = s2.size(); i < s1.size(); ++i)
+                expected_ops.emplace_back(rapidfuzz::EditType::Delete, i, s2.size());
+
+            for (size_t max : {size_t(0), size_t(1), size_t(4), expected, SIZE_MAX}) {
+                size_t expected_cutoff = (expected <= max) ? expected : max + 1;
+                REQUIRE(rapidfuzz::hamming_distance(s1, s2, true, max) == expected_cutoff);
+                REQUIRE(rapidfuzz::hamming_distance(s2, s1, true, max) == expected_cutoff);
+                REQUIRE(rapidfuzz::hamming_distance(s1.data(), s1.data() + s1.size(), s2.data(),
+                                                    s2.data() + s2.size(), true, max) == expected_cutoff);
+            }
+
+            REQUIRE(rapidfuzz::hamming_editops(s1, s2) == expected_ops);
+        }
+    }
+}
+
+TEST_CASE("Hamming long strings")
+{
+    std::mt19937 gen(42);
+    test_hamming_long_strings<char>(gen);
+    test_hamming_long_strings<uint8_t>(gen);
+    test_hamming_long_strings<char16_t>(gen);
+    test_hamming_long_strings<char32_t>(gen);
+    test_hamming_long_strings<uint64_t>(gen);
+
+    std::string s1(200, 'a');
+    std::string s2 = s1;
+    s2[3] = 'b';
+    s2[150] = 'b';
+    REQUIRE(hamming_distance(s1, s2) == 2);
+    REQUIRE(rapidfuzz::hamming_distance(s1, s2, true, 1) == 2);
+    REQUIRE(rapidfuzz::hamming_editops(s1, s2).size() == 2);
+}
+
+#ifdef RAPIDFUZZ_SIMD
+template <int MaxLen>
+static void test_multi_hamming(const std::vector<std::string>& strings, const std::string& s2)
+{
+    rapidfuzz::experimental::MultiHamming<MaxLen> scorer(strings.size());
+    for (const auto& s1 : strings)
+        scorer.insert(s1);
+
+    std::vector<size_t> results(scorer.result_count());
+    std::vector<double> norm_results(scorer.result_count());
+    for (size_t max : {size_t(0), size_t(1), size_t(2), size_t(5), std::numeric_limits<size_t>::max()}) {
+        scorer.distance(&results[0], results.size(), s2, max);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            INFO("s1: " << strings[i] << " s2: " << s2 << " max: " << max);
+            REQUIRE(results[i] == rapidfuzz::hamming_distance(strings[i], s2, true, max));
+        }
+    }
+
+    scorer.normalized_similarity(&norm_results[0], norm_results.size(), s2, 0.8);
+    for (size_t i = 0; i < strings.size(); ++i)
+        REQUIRE(norm_results[i] ==
+                Catch::Approx(rapidfuzz::hamming_normalized_similarity(strings[i], s2, true, 0.8)));
+}
+
+TEST_CASE("MultiHamming")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> base_dist(0, 3);
+    auto random_barcode = [&](size_t len) {
+        std::string s(len, 'A');
+        for (auto& ch : s)
+            ch = "ACGT"[base_dist(gen)];
+        return s;
+    };
+
+    SECTION("barcodes of a 96 well plate")
+    {
+        std::vector<std::string> barcodes;
+        for (size_t i = 0; i < 96; ++i)
+            barcodes.push_back(random_barcode(8));
+
+        for (size_t i = 0; i < 20; ++i) {
+            std::string read = barcodes[i];
+            read[i % read.size()] = 'N';
+            test_multi_hamming<8>(barcodes, read);
+            test_multi_hamming<16>(barcodes, random_barcode(8));
+            test_multi_hamming<64>(barcodes, read);
+        }
+    }
+
+    SECTION("strings of different length")
+    {
+        std::vector<std::string> strings = {"", "A", "ACGT", random_barcode(31), random_barcode(32),
+                                            random_barcode(63), random_barcode(64)};
+        std::vector<std::string> queries = {"", "ACGA", random_barcode(40), random_barcode(300)};
+        for (const auto& s2 : queries) {
+            test_multi_hamming<64>(strings, s2);
+            test_multi_hamming<64>(strings, strings[3]);
+        }
+    }
+
+    SECTION("pad = false requires strings of the same length")
+    {
+        rapidfuzz::experimental::MultiHamming<8> scorer(2, false);
+        scorer.insert(std::string("ACGT"));
+        scorer.insert(std::string("ACGA"));
+        std::vector<size_t> results(scorer.result_count());
+        scorer.distance(&results[0], results.size(), std::string("AGGT"));
+        REQUIRE(results[0] == 1);
+        REQUIRE(results[1] == 2);
+        REQUIRE_THROWS_AS(scorer.distance(&results[0], results.size(), std::string("ACG")),
+                          std::invalid_argument);
+    }
+}
+#endif
@@ -23,7 +23,7 @@ size_t indel_distance(const Sentence1& s1, const Sentence2& s2,
     size_t res5 = scorer.distance(s2.begin(), s2.end(), max);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiIndel<8> simd_scorer(1);
@@ -71,7 +71,7 @@ size_t indel_similarity(const Sentence1& s1, const Sentence2& s2, size_t max = 0
     size_t res5 = scorer.similarity(s2.begin(), s2.end(), max);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiIndel<8> simd_scorer(1);
@@ -118,7 +118,7 @@ double indel_normalized_distance(const Sentence1& s1, const Sentence2& s2, doubl
     double res5 = scorer.normalized_distance(s2.begin(), s2.end(), score_cutoff);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<double> results(256 / 8);
+        std::vector<double> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiIndel<8> simd_scorer(1);
@@ -165,7 +165,7 @@ double indel_normalized_similarity(const Sentence1& s1, const Sentence2& s2, dou
     double res5 = scorer.normalized_similarity(s2.begin(), s2.end(), score_cutoff);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<double> results(256 / 8);
+        std::vector<double> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiIndel<8> simd_scorer(1);
@@ -27,7 +27,7 @@ double jaro_similarity(const Sentence1& s1, const Sentence2& s2, double score_cu
     double res9 = scorer.normalized_similarity(s2.begin(), s2.end(), score_cutoff);
 
 #ifdef RAPIDFUZZ_SIMD
-    std::vector<double> results(256 / 8);
+    std::vector<double> results(512 / 8);
     if (s1.size() <= 8) {
         rapidfuzz::experimental::MultiJaro<8> simd_scorer(32);
         for(size_t i = 0; i < 32; ++i)
@@ -97,7 +97,7 @@ double jaro_distance(const Sentence1& s1, const Sentence2& s2, double score_cuto
     double res9 = scorer.normalized_distance(s2.begin(), s2.end(), score_cutoff);
 
 #ifdef RAPIDFUZZ_SIMD
-    std::vector<double> results(256 / 8);
+    std::vector<double> results(512 / 8);
     if (s1.size() <= 8) {
         rapidfuzz::experimental::MultiJaro<8> simd_scorer(32);
         for(size_t i = 0; i < 32; ++i)
@@ -24,7 +24,7 @@ double jaro_winkler_similarity(const Sentence1& s1, const Sentence2& s2, double
     double res8 = scorer.normalized_similarity(s2.begin(), s2.end(), score_cutoff);
 
 #ifdef RAPIDFUZZ_SIMD
-    std::vector<double> results(256 / 8);
+    std::vector<double> results(512 / 8);
     if (s1.size() <= 8) {
         rapidfuzz::experimental::MultiJaroWinkler<8> simd_scorer(32, prefix_weight);
         for (unsigned int i = 0; i < 32; ++i)
@@ -80,7 +80,7 @@ double jaro_winkler_distance(const Sentence1& s1, const Sentence2& s2, double pr
     double res8 = scorer.normalized_distance(s2.begin(), s2.end(), score_cutoff);
 
 #ifdef RAPIDFUZZ_SIMD
-    std::vector<double> results(256 / 8);
+    std::vector<double> results(512 / 8);
     if (s1.size() <= 8) {
         rapidfuzz::experimental::MultiJaroWinkler<8> simd_scorer(1, prefix_weight);
         simd_scorer.insert(s1);
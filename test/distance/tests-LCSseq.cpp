@@ -1,6 +1,7 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <rapidfuzz/distance/LCSseq.hpp>
+#include <random>
 #include <string>
 
 #include <rapidfuzz/distance/Indel.hpp>
@@ -21,7 +22,7 @@ size_t lcs_seq_distance(const Sentence1& s1, const Sentence2& s2,
     size_t res5 = scorer.distance(s2.begin(), s2.end(), max);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiLCSseq<8> simd_scorer(1);
@@ -69,7 +70,7 @@ size_t lcs_seq_similarity(const Sentence1& s1, const Sentence2& s2, size_t max =
     size_t res5 = scorer.similarity(s2.begin(), s2.end(), max);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiLCSseq<8> simd_scorer(1);
@@ -199,6 +200,38 @@ TEST_CASE("LCSseq")
     }
 }
 
+TEST_CASE("LCSseq long strings with score_cutoff")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+    auto random_string = [&](size_t len) {
+        std::string s(len, 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        return s;
+    };
+
+    /* the cutoffs around the similarity stop the calculation early or reject it */
+    for (size_t len1 : {300, 1000, 3000}) {
+        std::string s1 = random_string(len1);
+        std::string s2 = s1;
+        for (size_t i = 0; i < len1 / 50; ++i)
+            s2.insert(s2.begin() + static_cast<ptrdiff_t>(gen() % s2.size()), 'e');
+        s2.erase(0, len1 / 10);
+        std::string s3 = random_string(len1 + 20);
+
+        for (const auto& other : {s2, s3}) {
+            size_t sim = lcs_seq_similarity(s1, other);
+            for (size_t cutoff : {sim / 2, sim - 1, sim, sim + 1, sim + 50, std::min(len1, other.size())}) {
+                INFO("len1: " << len1 << " cutoff: " << cutoff);
+                size_t expected = (sim >= cutoff) ? sim : 0;
+                REQUIRE(lcs_seq_similarity(s1, other, cutoff) == expected);
+                REQUIRE(lcs_seq_similarity(other, s1, cutoff) == expected);
+            }
+        }
+    }
+}
+
 #ifdef RAPIDFUZZ_SIMD
 TEST_CASE("SIMD wraparound")
 {
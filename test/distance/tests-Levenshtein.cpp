@@ -3,7 +3,10 @@
 #include <rapidfuzz/details/Range.hpp>
 #include <rapidfuzz/details/types.hpp>
 #include <rapidfuzz/distance/Levenshtein.hpp>
+#include <algorithm>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "examples/ocr.hpp"
 #include <rapidfuzz/distance.hpp>
@@ -26,7 +29,7 @@ size_t levenshtein_distance(const Sentence1& s1, const Sentence2& s2,
 #ifdef RAPIDFUZZ_SIMD
     if (weights.delete_cost == 1 && weights.insert_cost == 1 && weights.replace_cost == 1 && s1.size() <= 64)
     {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiLevenshtein<8> simd_scorer(1);
@@ -271,6 +274,30 @@ TEST_CASE("Levenshtein_blockwise")
         std::string s2 = str_multiply(std::string("b"), 128);
         REQUIRE(levenshtein_distance(s1, s2, {1, 1, 1}) == 128);
     }
+
+    /* the cutoffs around the distance shrink the band until it stops to exist */
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+    for (size_t len1 : {300, 1000, 3000}) {
+        std::string s1(len1, 'a');
+        for (auto& ch : s1)
+            ch = static_cast<char>(char_dist(gen));
+        std::string s2 = s1;
+        for (size_t i = 0; i < len1 / 20; ++i)
+            s2[gen() % s2.size()] = 'e';
+        s2.erase(0, len1 / 30);
+        std::string s3 = s1.substr(len1 / 2) + s1.substr(0, len1 / 2);
+
+        for (const auto& other : {s2, s3}) {
+            size_t dist = levenshtein_distance(s1, other);
+            for (size_t cutoff : {dist / 2, dist - 1, dist, dist + 1, dist + 50}) {
+                INFO("len1: " << len1 << " cutoff: " << cutoff);
+                size_t expected = (dist <= cutoff) ? dist : cutoff + 1;
+                REQUIRE(levenshtein_distance(s1, other, {1, 1, 1}, cutoff) == expected);
+                REQUIRE(levenshtein_distance(other, s1, {1, 1, 1}, cutoff) == expected);
+            }
+        }
+    }
 }
 
 TEST_CASE("Levenshtein_editops[fuzzing_regressions]")
@@ -437,6 +464,238 @@ TEST_CASE("Levenshtein large band")
         REQUIRE(ops1.size() == 5278);
         REQUIRE(ocr_example2 == rapidfuzz::editops_apply<uint8_t>(ops1, ocr_example1, ocr_example2));
     }
+    /* split into small parts, which are aligned using multiple threads */
+    {
+        rapidfuzz::Editops ops1 = rapidfuzz::levenshtein_editops(ocr_example1, ocr_example2);
+        for (size_t workers : {size_t(1), size_t(2), size_t(3), size_t(8)}) {
+            rapidfuzz::Editops ops2 = rapidfuzz::levenshtein_editops(
+                ocr_example1, ocr_example2, std::numeric_limits<size_t>::max(), nullptr, workers, 4096);
+            REQUIRE(ops2.size() == 5278);
+            REQUIRE(ocr_example2 == rapidfuzz::editops_apply<uint8_t>(ops2, ocr_example1, ocr_example2));
+
+            rapidfuzz::Editops ops3 = rapidfuzz::levenshtein_editops(
+                ocr_example1, ocr_example2, std::numeric_limits<size_t>::max(), nullptr, workers);
+            REQUIRE(ops3 == ops1);
+        }
+    }
+}
+
+template <typename CharT>
+static void check_for_each_editop(const std::basic_string<CharT>& s1, const std::basic_string<CharT>& s2,
+                                  size_t memory_budget)
+{
+    rapidfuzz::Editops ops =
+        rapidfuzz::levenshtein_editops(s1, s2, std::numeric_limits<size_t>::max(), nullptr, 1, memory_budget);
+
+    rapidfuzz::Editops streamed;
+    rapidfuzz::levenshtein_for_each_editop(
+        s1, s2, [&](const rapidfuzz::EditOp& op) { streamed.push_back(op); },
+        std::numeric_limits<size_t>::max(), memory_budget);
+    streamed.set_src_len(s1.size());
+    streamed.set_dest_len(s2.size());
+    REQUIRE(streamed == ops);
+    REQUIRE(s2 == rapidfuzz::editops_apply<CharT>(streamed, s1, s2));
+
+    rapidfuzz::Opcodes opcodes;
+    opcodes.set_src_len(s1.size());
+    opcodes.set_dest_len(s2.size());
+    rapidfuzz::levenshtein_for_each_opcode(
+        s1, s2, [&](const rapidfuzz::Opcode& op) { opcodes.push_back(op); },
+        std::numeric_limits<size_t>::max(), memory_budget);
+    REQUIRE(opcodes == rapidfuzz::Opcodes(streamed));
+}
+
+TEST_CASE("Levenshtein_for_each_editop")
+{
+    SECTION("simple")
+    {
+        check_for_each_editop<char>("Lorem ipsum", "XYZLorem ABC iPsum", 1024 * 1024);
+        check_for_each_editop<char>("aaaa", "aaaa", 1024 * 1024);
+        check_for_each_editop<char>("", "abc", 1024 * 1024);
+    }
+
+    SECTION("split using Hirschbergs algorithm")
+    {
+        check_for_each_editop(ocr_example1, ocr_example2, 1024 * 1024);
+        check_for_each_editop(ocr_example1, ocr_example2, 4096);
+    }
+}
+
+TEST_CASE("CompactEditops")
+{
+    SECTION("conversion")
+    {
+        rapidfuzz::Editops ops = rapidfuzz::levenshtein_editops(ocr_example1, ocr_example2);
+        rapidfuzz::CompactEditops compact(ops);
+        REQUIRE(compact.size() == ops.size());
+        REQUIRE(compact.get_src_len() == ops.get_src_len());
+        REQUIRE(compact.get_dest_len() == ops.get_dest_len());
+        REQUIRE(std::equal(compact.begin(), compact.end(), ops.begin()));
+        REQUIRE(rapidfuzz::Editops(compact) == ops);
+        REQUIRE(ocr_example2 == rapidfuzz::editops_apply<uint8_t>(compact, ocr_example1, ocr_example2));
+
+        rapidfuzz::Opcodes opcodes(ops);
+        REQUIRE(rapidfuzz::Opcodes(compact) == opcodes);
+        REQUIRE(rapidfuzz::CompactEditops(opcodes) == compact);
+    }
+
+    SECTION("filled by levenshtein_for_each_editop")
+    {
+        std::string s1 = "Lorem ipsum.";
+        std::string s2 = "XYZLorem ABC iPsum";
+        rapidfuzz::CompactEditops compact;
+        compact.set_src_len(s1.size());
+        compact.set_dest_len(s2.size());
+        rapidfuzz::levenshtein_for_each_editop(s1, s2,
+                                               [&](const rapidfuzz::EditOp& op) { compact.push_back(op); });
+        REQUIRE(rapidfuzz::Editops(compact) == rapidfuzz::levenshtein_editops(s1, s2));
+        REQUIRE(s2 == rapidfuzz::editops_apply<char>(compact, s1, s2));
+    }
+
+    if constexpr (sizeof(size_t) > sizeof(uint32_t)) {
+        SECTION("positions above 2^32")
+        {
+            size_t pos = size_t(UINT32_MAX) + 1;
+            rapidfuzz::CompactEditops compact;
+            REQUIRE_THROWS_AS(compact.push_back({rapidfuzz::EditType::Insert, pos, 0}), std::invalid_argument);
+            REQUIRE_THROWS_AS(compact.set_dest_len(pos), std::invalid_argument);
+            REQUIRE(compact.empty());
+        }
+    }
+}
+
+static std::vector<rapidfuzz::LevenshteinMatch> levenshtein_search_reference(const std::string& s1,
+                                                                             const std::string& s2,
+                                                                             size_t max, bool record_start)
+{
+    /* first row of the matrix is zero, so matches can start anywhere */
+    std::vector<size_t> row(s1.size() + 1);
+    for (size_t i = 0; i <= s1.size(); ++i)
+        row[i] = i;
+
+    std::vector<rapidfuzz::LevenshteinMatch> matches;
+    for (size_t end = 1; end <= s2.size(); ++end) {
+        size_t diag = 0;
+        row[0] = 0;
+        for (size_t i = 1; i <= s1.size(); ++i) {
+            size_t temp = row[i];
+            row[i] = std::min({row[i] + 1, row[i - 1] + 1, diag + (s1[i - 1] != s2[end - 1])});
+            diag = temp;
+        }
+        if (row[s1.size()] > max) continue;
+
+        size_t start = rapidfuzz::LevenshteinMatch::npos;
+        if (record_start) {
+            start = end;
+            while (rapidfuzz::levenshtein_distance(s1, s2.substr(start, end - start)) != row[s1.size()])
+                --start;
+        }
+        matches.push_back({start, end, row[s1.size()]});
+    }
+    return matches;
+}
+
+TEST_CASE("LevenshteinSearcher")
+{
+    SECTION("simple")
+    {
+        rapidfuzz::LevenshteinSearcher searcher(std::string("error"), 1, true);
+        std::vector<rapidfuzz::LevenshteinMatch> matches = searcher.search(std::string("an eror occured"));
+        std::vector<rapidfuzz::LevenshteinMatch> expected = {{3, 7, 1}};
+        REQUIRE(matches == expected);
+
+        rapidfuzz::LevenshteinSearcher searcher2(std::string("error"), 1);
+        matches = searcher2.search(std::string("an eror occured"));
+        expected = {{rapidfuzz::LevenshteinMatch::npos, 7, 1}};
+        REQUIRE(matches == expected);
+    }
+
+    SECTION("random")
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> char_dist('a', 'c');
+        auto random_string = [&](size_t len) {
+            std::string s(len, 'a');
+            for (auto& ch : s)
+                ch = static_cast<char>(char_dist(gen));
+            return s;
+        };
+
+        for (size_t len1 : {0, 1, 5, 63, 64, 65, 130, 200}) {
+            std::string s1 = random_string(len1);
+            /* contains modified copies of s1, so there are matches in the long patterns as well */
+            std::string s2 = random_string(50) + s1 + random_string(100) + s1.substr(len1 / 2) +
+                             random_string(20) + s1.substr(0, len1 / 3) + s1.substr(len1 / 2);
+            for (size_t max : {0, 1, 3, 20, 70, 300}) {
+                for (bool record_start : {false, true}) {
+                    INFO("len1: " << len1 << " max: " << max << " record_start: " << record_start);
+                    auto expected = levenshtein_search_reference(s1, s2, max, record_start);
+
+                    rapidfuzz::LevenshteinSearcher searcher(s1, max, record_start);
+                    REQUIRE(searcher.search(s2) == expected);
+                    REQUIRE(searcher.search(s2.begin(), s2.end()) == expected);
+
+                    /* stream the text in chunks of different sizes */
+                    for (size_t chunk_size : {1, 7, 64, 1000}) {
+                        searcher.reset();
+                        std::vector<rapidfuzz::LevenshteinMatch> matches;
+                        for (size_t pos = 0; pos < s2.size(); pos += chunk_size) {
+                            std::string chunk = s2.substr(pos, chunk_size);
+                            searcher.feed(chunk, [&](const auto& match) { matches.push_back(match); });
+                        }
+                        REQUIRE(searcher.position() == s2.size());
+                        REQUIRE(matches == expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("IncrementalLevenshtein")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+    std::uniform_int_distribution<int> action_dist(0, 3);
+
+    for (size_t len1 : {0, 1, 5, 64, 65, 200}) {
+        std::string s1(len1, 'a');
+        for (auto& ch : s1)
+            ch = static_cast<char>(char_dist(gen));
+
+        rapidfuzz::IncrementalLevenshtein scorer(s1);
+        rapidfuzz::CachedLevenshtein<char> cached_scorer(s1);
+        std::string s2;
+        for (size_t i = 0; i < 300; ++i) {
+            /* type and delete characters like a user of an autocomplete */
+            int action = action_dist(gen);
+            if (action == 0 && !s2.empty()) {
+                s2.pop_back();
+                scorer.pop_back();
+            }
+            else if (action == 1 && s2.size() > 5) {
+                s2.resize(s2.size() - 5);
+                scorer.rollback(s2.size());
+            }
+            else {
+                s2.push_back(static_cast<char>(char_dist(gen)));
+                scorer.push_back(s2.back());
+            }
+
+            INFO("s1: " << s1 << " s2: " << s2);
+            REQUIRE(scorer.size() == s2.size());
+            REQUIRE(scorer.distance() == rapidfuzz::levenshtein_distance(s1, s2));
+            REQUIRE(scorer.distance(3) == cached_scorer.distance(s2, 3));
+            REQUIRE(scorer.similarity(50) == cached_scorer.similarity(s2, 50));
+            REQUIRE(scorer.normalized_distance(0.5) == cached_scorer.normalized_distance(s2, 0.5));
+            REQUIRE(scorer.normalized_similarity(0.5) == cached_scorer.normalized_similarity(s2, 0.5));
+        }
+
+        scorer.clear();
+        scorer.append(std::string("abcd"));
+        REQUIRE(scorer.distance() == rapidfuzz::levenshtein_distance(s1, std::string("abcd")));
+        REQUIRE_THROWS_AS(scorer.rollback(5), std::invalid_argument);
+    }
 }
 
 #ifdef RAPIDFUZZ_SIMD
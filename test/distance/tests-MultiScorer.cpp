@@ -0,0 +1,95 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <rapidfuzz/distance/MultiScorer.hpp>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef RAPIDFUZZ_SIMD
+static std::vector<std::string> get_strings()
+{
+    /* mix of all bucket sizes and strings which are too long for the simd scorers */
+    std::vector<std::string> strings;
+    for (size_t len : {0, 3, 8, 9, 16, 17, 31, 32, 33, 64, 65, 150, 300})
+        for (size_t i = 0; i < 5; ++i)
+            strings.push_back(std::string(len, static_cast<char>('a' + i)) + std::string(i, 'b'));
+    /* interleave the lengths */
+    std::vector<std::string> interleaved;
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t j = i; j < strings.size(); j += 5)
+            interleaved.push_back(strings[j]);
+    return interleaved;
+}
+
+TEST_CASE("MultiScorer")
+{
+    auto strings = get_strings();
+    std::vector<std::string> queries = {"", "aaa", "aaaaaaaaab", std::string(70, 'a'), std::string(200, 'c')};
+
+    SECTION("Levenshtein")
+    {
+        rapidfuzz::experimental::MultiScorerLevenshtein<char> scorer(strings);
+        for (const auto& s2 : queries) {
+            for (size_t score_cutoff : {size_t(3), std::numeric_limits<size_t>::max()}) {
+                std::vector<size_t> results(scorer.result_count());
+                scorer.distance(results.data(), results.size(), s2, score_cutoff);
+                for (size_t i = 0; i < strings.size(); ++i)
+                    REQUIRE(results[i] ==
+                            rapidfuzz::levenshtein_distance(strings[i], s2, {1, 1, 1}, score_cutoff));
+
+                scorer.similarity(results.data(), results.size(), s2, score_cutoff);
+                for (size_t i = 0; i < strings.size(); ++i)
+                    REQUIRE(results[i] ==
+                            rapidfuzz::levenshtein_similarity(strings[i], s2, {1, 1, 1}, score_cutoff));
+            }
+
+            std::vector<double> norm_results(scorer.result_count());
+            scorer.normalized_similarity(norm_results.data(), norm_results.size(), s2, 0.5);
+            for (size_t i = 0; i < strings.size(); ++i)
+                REQUIRE(norm_results[i] == Catch::Approx(rapidfuzz::levenshtein_normalized_similarity(
+                                               strings[i], s2, {1, 1, 1}, 0.5)));
+        }
+    }
+
+    SECTION("Indel")
+    {
+        rapidfuzz::experimental::MultiScorerIndel<char> scorer(strings);
+        for (const auto& s2 : queries) {
+            std::vector<size_t> results(scorer.result_count());
+            scorer.distance(results.data(), results.size(), s2);
+            for (size_t i = 0; i < strings.size(); ++i)
+                REQUIRE(results[i] == rapidfuzz::indel_distance(strings[i], s2));
+        }
+    }
+
+    SECTION("OSA")
+    {
+        rapidfuzz::experimental::MultiScorerOSA<char> scorer(strings);
+        for (const auto& s2 : queries) {
+            std::vector<double> results(scorer.result_count());
+            scorer.normalized_distance(results.data(), results.size(), s2);
+            for (size_t i = 0; i < strings.size(); ++i)
+                REQUIRE(results[i] == Catch::Approx(rapidfuzz::osa_normalized_distance(strings[i], s2)));
+        }
+    }
+
+    SECTION("JaroWinkler")
+    {
+        rapidfuzz::experimental::MultiScorerJaroWinkler<char> scorer(strings, 0.2);
+        for (const auto& s2 : queries) {
+            std::vector<double> results(scorer.result_count());
+            scorer.similarity(results.data(), results.size(), s2);
+            for (size_t i = 0; i < strings.size(); ++i)
+                REQUIRE(results[i] == Catch::Approx(rapidfuzz::jaro_winkler_similarity(strings[i], s2, 0.2)));
+        }
+    }
+
+    SECTION("result_count")
+    {
+        rapidfuzz::experimental::MultiScorerJaro<char> scorer(strings);
+        std::vector<double> results(strings.size() - 1);
+        REQUIRE_THROWS_AS(scorer.similarity(results.data(), results.size(), "test"), std::invalid_argument);
+    }
+}
+#endif
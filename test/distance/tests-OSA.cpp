@@ -19,7 +19,7 @@ size_t osa_distance(const Sentence1& s1, const Sentence2& s2, size_t max = std::
     size_t res5 = scorer.distance(s2.begin(), s2.end(), max);
 #ifdef RAPIDFUZZ_SIMD
     if (s1.size() <= 64) {
-        std::vector<size_t> results(256 / 8);
+        std::vector<size_t> results(512 / 8);
 
         if (s1.size() <= 8) {
             rapidfuzz::experimental::MultiOSA<8> simd_scorer(1);
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rapidfuzz/distance/DamerauLevenshtein.hpp>
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/index/BKTree.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using Results = std::vector<rapidfuzz::process::ExtractResult<size_t>>;
+
+static std::vector<std::string> get_strings()
+{
+    /* small alphabet, so there are many similar strings */
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> len_dist(0, 12);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    std::vector<std::string> strings = {"",       "ca",      "ac",     "abc",
+                                        "kitten", "sitting", "kitten", std::string(80, 'a')};
+    for (size_t i = 0; i < 300; ++i) {
+        std::string s(len_dist(gen), 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        strings.push_back(s);
+    }
+    return strings;
+}
+
+template <typename Func>
+static Results reference(const std::vector<std::string>& strings, Func func, size_t max_dist, size_t limit)
+{
+    Results results;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        size_t dist = func(strings[i]);
+        if (dist <= max_dist) results.push_back({dist, i});
+    }
+
+    std::stable_sort(results.begin(), results.end(),
+                     [](const auto& a, const auto& b) { return a.score < b.score; });
+    if (results.size() > limit) results.resize(limit);
+    return results;
+}
+
+template <template <typename> class CachedScorer, typename Func>
+static void test_tree(Func func)
+{
+    auto strings = get_strings();
+    rapidfuzz::BKTree<CachedScorer, char> tree;
+    for (const auto& s : strings)
+        tree.insert(s);
+    REQUIRE(tree.size() == strings.size());
+
+    std::vector<std::string> queries = {"",          "a",        "abcd",     "kitten", "dcbaabcd",
+                                        strings[20], std::string(78, 'a')};
+    for (const auto& query : queries) {
+        auto scorer = [&](const std::string& s) { return func(query, s); };
+        for (size_t max_dist : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(6), SIZE_MAX}) {
+            INFO("query: " << query << " max_dist: " << max_dist);
+            REQUIRE(tree.search(query, max_dist) == reference(strings, scorer, max_dist, SIZE_MAX));
+
+            for (size_t limit : {size_t(0), size_t(1), size_t(5), size_t(1000)}) {
+                INFO("limit: " << limit);
+                REQUIRE(tree.nearest(query, limit, max_dist) == reference(strings, scorer, max_dist, limit));
+            }
+        }
+    }
+}
+
+TEST_CASE("BKTree")
+{
+    SECTION("Levenshtein")
+    {
+        test_tree<rapidfuzz::CachedLevenshtein>(
+            [](const auto& s1, const auto& s2) { return rapidfuzz::levenshtein_distance(s1, s2); });
+    }
+
+    SECTION("DamerauLevenshtein")
+    {
+        test_tree<rapidfuzz::experimental::CachedDamerauLevenshtein>([](const auto& s1, const auto& s2) {
+            return rapidfuzz::experimental::damerau_levenshtein_distance(s1, s2);
+        });
+    }
+
+    SECTION("Indel")
+    {
+        test_tree<rapidfuzz::CachedIndel>(
+            [](const auto& s1, const auto& s2) { return rapidfuzz::indel_distance(s1, s2); });
+    }
+
+    SECTION("empty tree")
+    {
+        rapidfuzz::BKTree<rapidfuzz::CachedLevenshtein, char> tree;
+        REQUIRE(tree.search(std::string("abc"), 5).empty());
+        REQUIRE(tree.nearest(std::string("abc"), 5).empty());
+    }
+}
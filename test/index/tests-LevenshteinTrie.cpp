@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/index/LevenshteinTrie.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using Results = std::vector<rapidfuzz::process::ExtractResult<size_t>>;
+
+static std::vector<std::string> get_strings()
+{
+    /* paths with shared prefixes and a small alphabet, so there are many similar strings */
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> len_dist(0, 12);
+    std::uniform_int_distribution<size_t> prefix_dist(0, 4);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    std::vector<std::string> prefixes = {"", "/usr/lib/", "/usr/local/lib/", "/home/user/",
+                                         std::string(70, 'a')};
+    std::vector<std::string> strings = {"",       "a",       "ab",     "abc",
+                                        "kitten", "sitting", "kitten", std::string(130, 'a')};
+    for (size_t i = 0; i < 300; ++i) {
+        std::string s(len_dist(gen), 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        strings.push_back(prefixes[prefix_dist(gen)] + s);
+    }
+    return strings;
+}
+
+static Results search_reference(const std::vector<std::string>& strings, const std::string& query,
+                                size_t max_dist)
+{
+    Results results;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        size_t dist = rapidfuzz::levenshtein_distance(query, strings[i]);
+        if (dist <= max_dist) results.push_back({dist, i});
+    }
+
+    std::stable_sort(results.begin(), results.end(),
+                     [](const auto& a, const auto& b) { return a.score < b.score; });
+    return results;
+}
+
+TEST_CASE("LevenshteinTrie")
+{
+    auto strings = get_strings();
+    std::vector<std::string> queries = {"",
+                                        "a",
+                                        "abcd",
+                                        "kitten",
+                                        "/usr/lib/abcd",
+                                        "/usr/local/lib/dcba",
+                                        "/home/usr/abc",
+                                        strings[20],
+                                        strings[50],
+                                        std::string(72, 'a') + "bcd",
+                                        std::string(128, 'a')};
+
+    SECTION("matches a full scan")
+    {
+        rapidfuzz::LevenshteinTrie<char> trie;
+        for (const auto& s : strings)
+            trie.insert(s);
+        REQUIRE(trie.size() == strings.size());
+
+        for (const auto& query : queries) {
+            for (size_t max_dist : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(8), SIZE_MAX}) {
+                INFO("query: " << query << " max_dist: " << max_dist);
+                REQUIRE(trie.search(query, max_dist) == search_reference(strings, query, max_dist));
+                REQUIRE(trie.search(query.begin(), query.end(), max_dist) ==
+                        search_reference(strings, query, max_dist));
+            }
+        }
+    }
+
+    SECTION("insert returns the index")
+    {
+        rapidfuzz::LevenshteinTrie<char> trie;
+        REQUIRE(trie.search(std::string("hello"), 5).empty());
+        REQUIRE(trie.insert(std::string("hello")) == 0);
+        REQUIRE(trie.insert(std::string("help")) == 1);
+        REQUIRE(trie.insert(std::string("hello")) == 2);
+        REQUIRE(trie.search(std::string("hell"), 1) == Results{{1, 0}, {1, 1}, {1, 2}});
+        REQUIRE(trie.search(std::string("xyz"), 2).empty());
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/index/QGramIndex.hpp>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Results = std::vector<rapidfuzz::process::ExtractResult<size_t>>;
+
+static std::vector<std::string> get_strings()
+{
+    /* small alphabet, so there are many similar strings */
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> len_dist(0, 20);
+    std::uniform_int_distribution<int> char_dist('a', 'd');
+
+    std::vector<std::string> strings = {"", "a", "ab", "abc", "kitten", "sitting", std::string(100, 'a'),
+                                        std::string(98, 'a') + "bc"};
+    for (size_t i = 0; i < 300; ++i) {
+        std::string s(len_dist(gen), 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        strings.push_back(s);
+    }
+    return strings;
+}
+
+static Results search_reference(const std::vector<std::string>& strings, const std::string& query,
+                                size_t max_dist)
+{
+    Results results;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        size_t dist = rapidfuzz::levenshtein_distance(query, strings[i]);
+        if (dist <= max_dist) results.push_back({dist, i});
+    }
+
+    std::stable_sort(results.begin(), results.end(),
+                     [](const auto& a, const auto& b) { return a.score < b.score; });
+    return results;
+}
+
+TEST_CASE("QGramIndex")
+{
+    auto strings = get_strings();
+    std::vector<std::string> queries = {"",           "a",        "abcd",   "kitten", "abcdabcdabcd",
+                                        "dcbaabcddcba", strings[20], strings[50], std::string(99, 'a')};
+
+    SECTION("matches a full scan")
+    {
+        for (size_t q : {1, 2, 3, 4}) {
+            rapidfuzz::QGramIndex<char> index(q);
+            for (const auto& s : strings)
+                index.insert(s);
+            REQUIRE(index.size() == strings.size());
+
+            for (const auto& query : queries) {
+                for (size_t max_dist : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(8), SIZE_MAX}) {
+                    INFO("q: " << q << " query: " << query << " max_dist: " << max_dist);
+                    REQUIRE(index.search(query, max_dist) == search_reference(strings, query, max_dist));
+                }
+            }
+        }
+    }
+
+    SECTION("insert returns the index")
+    {
+        rapidfuzz::QGramIndex<char> index;
+        REQUIRE(index.insert(std::string("hello")) == 0);
+        REQUIRE(index.insert(std::string("world")) == 1);
+        REQUIRE(index.search(std::string("word"), 1) == Results{{1, 1}});
+        REQUIRE(index.search(std::string("xyz"), 2).empty());
+    }
+
+    SECTION("invalid q")
+    {
+        REQUIRE_THROWS_AS(rapidfuzz::QGramIndex<char>(0), std::invalid_argument);
+    }
+}
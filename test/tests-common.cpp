@@ -1,6 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <rapidfuzz/details/PatternMatchVector.hpp>
 #include <rapidfuzz/details/common.hpp>
+#include <rapidfuzz/distance/Indel.hpp>
+#include <rapidfuzz/distance/Levenshtein.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 TEST_CASE("remove affix")
 {
@@ -33,3 +41,213 @@ TEST_CASE("remove affix")
         REQUIRE(s2_ == rapidfuzz::detail::Range("abbbba"));
     }
 }
+
+using rapidfuzz::detail::BlockPatternMatchVector;
+
+static BlockPatternMatchVector view_of(const BlockPatternMatchVector& PM, std::vector<uint64_t>& buffer)
+{
+    buffer.assign(rapidfuzz::detail::ceil_div(PM.serialized_size(), sizeof(uint64_t)), 0);
+    PM.serialize(buffer.data());
+    return BlockPatternMatchVector::view(buffer.data(), PM.serialized_size());
+}
+
+TEST_CASE("serialized BlockPatternMatchVector")
+{
+    std::vector<std::u32string> strings = {U"", U"a", U"aaaa\u4e00bc",
+                                           std::u32string(150, U'b') + U"\u4e00a"};
+    std::vector<std::u32string> choices = {U"", U"ab", std::u32string(148, U'b') + U"\u4e00",
+                                           U"\u4e00\u4e00"};
+
+    for (const auto& s1 : strings) {
+        BlockPatternMatchVector PM{rapidfuzz::detail::Range(s1)};
+        std::vector<uint64_t> buffer;
+        auto view = view_of(PM, buffer);
+        REQUIRE(view.is_view());
+        REQUIRE(!PM.is_view());
+        REQUIRE(view.size() == PM.size());
+        REQUIRE(view.serialized_size() == PM.serialized_size());
+
+        for (size_t block = 0; block < PM.size(); ++block)
+            for (char32_t ch : {U'a', U'b', U'c', U'\u4e00', U'\u4e01'})
+                REQUIRE(view.get(block, ch) == PM.get(block, ch));
+
+        /* copies of a view keep referencing the serialized data */
+        auto copy = view;
+        REQUIRE(copy.is_view());
+
+        rapidfuzz::CachedLevenshtein<char32_t> scorer(s1);
+        rapidfuzz::CachedLevenshtein<char32_t> view_scorer(s1, std::move(copy));
+        rapidfuzz::CachedIndel<char32_t> indel_scorer(s1);
+        rapidfuzz::CachedIndel<char32_t> indel_view_scorer(s1, view);
+        for (const auto& s2 : choices) {
+            REQUIRE(view_scorer.distance(s2) == scorer.distance(s2));
+            REQUIRE(view_scorer.distance(s2, 2) == scorer.distance(s2, 2));
+            REQUIRE(indel_view_scorer.distance(s2) == indel_scorer.distance(s2));
+        }
+    }
+
+    SECTION("invalid data")
+    {
+        std::string s1(100, 'a');
+        BlockPatternMatchVector PM{rapidfuzz::detail::Range(s1)};
+        std::vector<uint64_t> buffer(PM.serialized_size() / sizeof(uint64_t) + 1);
+        PM.serialize(buffer.data());
+
+        REQUIRE_THROWS_AS(BlockPatternMatchVector::view(buffer.data(), PM.serialized_size() - 1),
+                          std::invalid_argument);
+        REQUIRE_THROWS_AS(BlockPatternMatchVector::view(reinterpret_cast<const char*>(buffer.data()) + 1,
+                                                        PM.serialized_size()),
+                          std::invalid_argument);
+        auto view = BlockPatternMatchVector::view(buffer.data(), PM.serialized_size());
+        REQUIRE_THROWS_AS(rapidfuzz::CachedLevenshtein<char>(std::string(10, 'a'), view),
+                          std::invalid_argument);
+
+        buffer[0] ^= 1;
+        REQUIRE_THROWS_AS(BlockPatternMatchVector::view(buffer.data(), PM.serialized_size()),
+                          std::invalid_argument);
+    }
+
+    SECTION("version 1 layout")
+    {
+        std::string s1(100, 'a');
+        BlockPatternMatchVector PM{rapidfuzz::detail::Range(s1)};
+        std::vector<uint64_t> buffer;
+        view_of(PM, buffer);
+
+        /* the version follows the 4 byte magic */
+        uint32_t version = 1;
+        std::memcpy(reinterpret_cast<char*>(buffer.data()) + sizeof(uint32_t), &version, sizeof(version));
+        REQUIRE_THROWS_AS(BlockPatternMatchVector::view(buffer.data(), PM.serialized_size()),
+                          std::invalid_argument);
+    }
+
+    SECTION("hashmap without empty slot")
+    {
+        std::u32string s1 = U"a\u4e00";
+        BlockPatternMatchVector PM{rapidfuzz::detail::Range(s1)};
+        std::vector<uint64_t> buffer;
+        view_of(PM, buffer);
+
+        /* lookups of missing keys would never terminate */
+        size_t map_size = PM.size() * sizeof(rapidfuzz::detail::BitvectorHashmap);
+        auto* map = reinterpret_cast<unsigned char*>(buffer.data()) + PM.serialized_size() - map_size;
+        std::fill(map, map + map_size, static_cast<unsigned char>(0xff));
+        REQUIRE_THROWS_AS(BlockPatternMatchVector::view(buffer.data(), PM.serialized_size()),
+                          std::invalid_argument);
+    }
+}
+
+TEST_CASE("compact BlockPatternMatchVector")
+{
+    std::string all_chars;
+    for (int ch = 0; ch < 256; ++ch)
+        all_chars.push_back(static_cast<char>(ch));
+
+    std::vector<std::string> strings = {"", "aabc", "\xff\x80" "a", all_chars.substr(1), all_chars,
+                                        std::string(100, 'a') + "b"};
+    std::vector<size_t> expected_rows = {1, 4, 4, 256, 256, 3};
+
+    for (size_t i = 0; i < strings.size(); ++i) {
+        const auto& s1 = strings[i];
+        BlockPatternMatchVector PM{rapidfuzz::detail::Range(s1)};
+        REQUIRE(PM.ascii_rows() == expected_rows[i]);
+
+        /* characters can be inserted into the full layout */
+        BlockPatternMatchVector full(s1.size());
+        full.insert(rapidfuzz::detail::Range(s1));
+        REQUIRE(full.ascii_rows() == 256);
+
+        std::vector<uint64_t> buffer;
+        auto view = view_of(PM, buffer);
+        for (size_t block = 0; block < PM.size(); ++block) {
+            for (int ch = 0; ch < 256; ++ch) {
+                char key = static_cast<char>(ch);
+                auto wide_key = static_cast<uint32_t>(ch);
+                REQUIRE(PM.get(block, key) == full.get(block, key));
+                REQUIRE(PM.get(block, wide_key) == full.get(block, wide_key));
+                REQUIRE(view.get(block, key) == full.get(block, key));
+            }
+        }
+    }
+}
+
+#ifdef RAPIDFUZZ_HAS_MEMORY_RESOURCE
+/* memory_resource counting the bytes currently allocated from it */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocated = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        allocated -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST_CASE("memory_resource")
+{
+    std::string s1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabbbbbbbb";
+    std::string s2 = "aaaaaaaaaaaaaaaaaaaaaaaaabbbbbbbbaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaacc";
+
+    SECTION("cached scorers")
+    {
+        CountingResource resource;
+        {
+            rapidfuzz::CachedLevenshtein<char> lev(s1, {1, 1, 1}, &resource);
+            rapidfuzz::CachedIndel<char> indel(s1, &resource);
+            REQUIRE(resource.allocated > 0);
+            REQUIRE(lev.distance(s2) == rapidfuzz::levenshtein_distance(s1, s2));
+            REQUIRE(indel.distance(s2) == rapidfuzz::indel_distance(s1, s2));
+
+            /* copies and moved from scorers use the global heap */
+            size_t allocated = resource.allocated;
+            rapidfuzz::CachedLevenshtein<char> lev_copy = lev;
+            REQUIRE(resource.allocated == allocated);
+            REQUIRE(lev_copy.distance(s2) == lev.distance(s2));
+
+            rapidfuzz::CachedIndel<char> indel_moved = std::move(indel);
+            REQUIRE(resource.allocated == allocated);
+            REQUIRE(indel_moved.distance(s2) == rapidfuzz::indel_distance(s1, s2));
+        }
+        REQUIRE(resource.allocated == 0);
+    }
+
+    SECTION("editops")
+    {
+        CountingResource resource;
+        {
+            rapidfuzz::Editops ops = rapidfuzz::levenshtein_editops(s1, s2, 64, &resource);
+            REQUIRE(resource.allocated == ops.size() * sizeof(rapidfuzz::EditOp));
+            REQUIRE(ops == rapidfuzz::levenshtein_editops(s1, s2));
+
+            rapidfuzz::Editops indel_ops = rapidfuzz::indel_editops(s1, s2, &resource);
+            REQUIRE(indel_ops == rapidfuzz::indel_editops(s1, s2));
+
+            size_t allocated = resource.allocated;
+            rapidfuzz::Editops copy = ops;
+            REQUIRE(resource.allocated == allocated);
+            REQUIRE(copy == ops);
+
+            rapidfuzz::Editops resource_copy(copy, &resource);
+            REQUIRE(resource.allocated > allocated);
+            REQUIRE(resource_copy == ops);
+
+            rapidfuzz::Editops empty(&resource);
+            REQUIRE(empty.empty());
+        }
+        REQUIRE(resource.allocated == 0);
+    }
+}
+#endif
@@ -3,6 +3,8 @@
 
 #include <rapidfuzz/fuzz.hpp>
 
+#include <random>
+
 #include "common.hpp"
 
 namespace fuzz = rapidfuzz::fuzz;
@@ -244,3 +246,82 @@ TEST_CASE("RatioTest")
         score_test(97.5274725, fuzz::partial_ratio(str2, str1, 97.5));
     }
 }
+
+TEST_CASE("CachedWRatio")
+{
+    std::vector<std::string> strings = {"new york mets",
+                                        "new YORK mets",
+                                        "the wonderful new york mets",
+                                        "new york mets vs atlanta braves",
+                                        "atlanta braves vs new york mets",
+                                        "new york city mets - atlanta braves",
+                                        "mets",
+                                        "fuzzy wuzzy was a bear",
+                                        "wuzzy fuzzy was a bear",
+                                        "a",
+                                        "{",
+                                        "{a",
+                                        "a{",
+                                        "",
+                                        str_multiply(std::string("abcd efgh "), 12),
+                                        str_multiply(std::string("efgh abcd "), 8)};
+
+    for (const auto& s1 : strings) {
+        fuzz::CachedWRatio<char> scorer(s1);
+        for (const auto& s2 : strings) {
+            for (double score_cutoff : {0.0, 50.0, 80.0, 89.0, 95.0, 100.0}) {
+                INFO("s1: " << s1 << " s2: " << s2 << " score_cutoff: " << score_cutoff);
+                score_test(fuzz::WRatio(s1, s2, score_cutoff), scorer.similarity(s2, score_cutoff));
+            }
+        }
+    }
+}
+
+static double partial_ratio_reference(const std::string& s1, const std::string& s2)
+{
+    /* best ratio of s1 and all substrings of s2 with the length of s1 and the prefixes / suffixes
+     * of s2, which are shorter than s1 */
+    double score = 0;
+    for (size_t i = 0; i + s1.size() <= s2.size(); ++i)
+        score = std::max(score, fuzz::ratio(s1, s2.substr(i, s1.size())));
+
+    for (size_t i = 1; i < s1.size(); ++i) {
+        score = std::max(score, fuzz::ratio(s1, s2.substr(0, i)));
+        score = std::max(score, fuzz::ratio(s1, s2.substr(s2.size() - i)));
+    }
+    return score;
+}
+
+TEST_CASE("partial_ratio short needles")
+{
+    /* needle lengths covering all lane widths of the simd implementation */
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> char_dist('a', 'e');
+    auto random_string = [&](size_t len) {
+        std::string s(len, 'a');
+        for (auto& ch : s)
+            ch = static_cast<char>(char_dist(gen));
+        return s;
+    };
+
+    for (size_t len1 : {1, 2, 7, 8, 9, 16, 17, 32, 33, 63, 64, 65}) {
+        for (size_t len2 : {len1 + 1, len1 + 7, len1 + 8, len1 + 40, 3 * len1 + 20}) {
+            std::string s1 = random_string(len1);
+            std::string s2 = random_string(len2);
+            fuzz::CachedPartialRatio<char> scorer(s1);
+            INFO("s1: " << s1 << " s2: " << s2);
+
+            double expected = partial_ratio_reference(s1, s2);
+            score_test(expected, fuzz::partial_ratio(s1, s2));
+            score_test(expected, scorer.similarity(s2));
+            score_test(expected, fuzz::partial_ratio(s1, s2, expected));
+            score_test(expected, scorer.similarity(s2, expected));
+            score_test(0, scorer.similarity(s2, expected + 0.1));
+
+            auto alignment = fuzz::partial_ratio_alignment(s1, s2);
+            REQUIRE(alignment.dest_end - alignment.dest_start <= len1);
+            score_test(expected, fuzz::ratio(s1, s2.substr(alignment.dest_start,
+                                                           alignment.dest_end - alignment.dest_start)));
+        }
+    }
+}
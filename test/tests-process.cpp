@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <rapidfuzz/distance/Levenshtein.hpp>
+#include <rapidfuzz/fuzz.hpp>
+#include <rapidfuzz/process.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace process = rapidfuzz::process;
+
+static const std::vector<std::string> choices = {"new york mets vs chicago cubs",
+                                                  "chicago cubs at new york mets",
+                                                  "atlanta braves vs pittsbugh pirates",
+                                                  "new york yankees vs boston red sox",
+                                                  "new york mets",
+                                                  "new york metz",
+                                                  "york mets new",
+                                                  "",
+                                                  "new york mets",
+                                                  "brooklyn nets"};
+
+/* naive reference: score everything and sort by score, then index */
+template <process::ScoreKind Kind, typename ScoreT, typename Func>
+std::vector<process::ExtractResult<ScoreT>> extract_reference(Func func, size_t limit, ScoreT score_cutoff)
+{
+    constexpr bool higher_is_better =
+        Kind == process::ScoreKind::Similarity || Kind == process::ScoreKind::NormalizedSimilarity;
+
+    std::vector<process::ExtractResult<ScoreT>> results;
+    for (size_t i = 0; i < choices.size(); ++i) {
+        ScoreT score = func(choices[i]);
+        if (higher_is_better ? score >= score_cutoff : score <= score_cutoff) results.push_back({score, i});
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
+        return higher_is_better ? a.score > b.score : a.score < b.score;
+    });
+    if (results.size() > limit) results.resize(limit);
+    return results;
+}
+
+TEST_CASE("extract")
+{
+    std::string query = "new york mets";
+
+    SECTION("similarity")
+    {
+        rapidfuzz::fuzz::CachedRatio<char> scorer(query);
+        auto func = [&](const std::string& s) { return rapidfuzz::fuzz::ratio(query, s); };
+
+        for (size_t limit = 0; limit <= choices.size() + 1; ++limit) {
+            for (double score_cutoff : {0.0, 50.0, 90.0, 100.0}) {
+                INFO("limit: " << limit << " score_cutoff: " << score_cutoff);
+                auto expected =
+                    extract_reference<process::ScoreKind::Similarity>(func, limit, score_cutoff);
+                REQUIRE(process::extract(scorer, choices, limit, score_cutoff) == expected);
+            }
+        }
+    }
+
+    SECTION("distance")
+    {
+        rapidfuzz::CachedLevenshtein<char> scorer(query);
+        auto func = [&](const std::string& s) { return rapidfuzz::levenshtein_distance(query, s); };
+
+        for (size_t limit = 0; limit <= choices.size() + 1; ++limit) {
+            for (size_t score_cutoff : {size_t(0), size_t(1), size_t(10), std::numeric_limits<size_t>::max()}) {
+                INFO("limit: " << limit << " score_cutoff: " << score_cutoff);
+                auto expected = extract_reference<process::ScoreKind::Distance>(func, limit, score_cutoff);
+                REQUIRE(process::extract<process::ScoreKind::Distance>(scorer, choices, limit, score_cutoff) ==
+                        expected);
+            }
+        }
+    }
+
+    SECTION("normalized distance")
+    {
+        rapidfuzz::CachedLevenshtein<char> scorer(query);
+        auto func = [&](const std::string& s) { return rapidfuzz::levenshtein_normalized_distance(query, s); };
+
+        for (size_t limit = 0; limit <= choices.size() + 1; ++limit) {
+            for (double score_cutoff : {0.0, 0.3, 1.0}) {
+                INFO("limit: " << limit << " score_cutoff: " << score_cutoff);
+                auto expected =
+                    extract_reference<process::ScoreKind::NormalizedDistance>(func, limit, score_cutoff);
+                REQUIRE(process::extract<process::ScoreKind::NormalizedDistance>(scorer, choices, limit,
+                                                                                score_cutoff) == expected);
+            }
+        }
+    }
+
+    SECTION("default score_cutoff")
+    {
+        rapidfuzz::CachedLevenshtein<char> scorer(query);
+        auto results = process::extract<process::ScoreKind::Distance>(scorer, choices, 3);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == process::ExtractResult<size_t>{0, 4});
+        REQUIRE(results[1] == process::ExtractResult<size_t>{0, 8});
+        REQUIRE(results[2] == process::ExtractResult<size_t>{1, 5});
+    }
+}
+
+TEST_CASE("extractOne")
+{
+    std::string query = "new york mets";
+
+    SECTION("similarity")
+    {
+        rapidfuzz::fuzz::CachedRatio<char> scorer(query);
+        auto result = process::extractOne(scorer, choices);
+        REQUIRE(result.has_value());
+        REQUIRE(result->index == 4);
+        REQUIRE(result->score == 100.0);
+
+        REQUIRE(!process::extractOne(rapidfuzz::fuzz::CachedRatio<char>("xyz"), choices, 50.0).has_value());
+    }
+
+    SECTION("distance")
+    {
+        rapidfuzz::CachedLevenshtein<char> scorer("brooklyn net");
+        auto result = process::extractOne<process::ScoreKind::Distance>(scorer, choices);
+        REQUIRE(result.has_value());
+        REQUIRE(result->index == 9);
+        REQUIRE(result->score == 1);
+
+        REQUIRE(!process::extractOne<process::ScoreKind::Distance>(scorer, choices, 0).has_value());
+    }
+
+    SECTION("empty choices")
+    {
+        rapidfuzz::fuzz::CachedRatio<char> scorer(query);
+        REQUIRE(!process::extractOne(scorer, std::vector<std::string>()).has_value());
+        REQUIRE(process::extract(scorer, std::vector<std::string>(), 5).empty());
+    }
+}
+
+template <typename ScoreT, typename Func>
+void cdist_test(const std::vector<ScoreT>& result, const std::vector<std::string>& queries,
+                const std::vector<std::string>& choices_, Func func)
+{
+    REQUIRE(result.size() == queries.size() * choices_.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        for (size_t j = 0; j < choices_.size(); ++j) {
+            INFO("query: " << queries[i] << " choice: " << choices_[j]);
+            REQUIRE(result[i * choices_.size() + j] == func(queries[i], choices_[j]));
+        }
+    }
+}
+
+TEST_CASE("cdist")
+{
+    /* large enough to be split into multiple tiles */
+    std::vector<std::string> queries;
+    std::vector<std::string> short_choices;
+    std::vector<std::string> long_choices;
+    for (size_t i = 0; i < 40; ++i)
+        queries.push_back(choices[i % choices.size()].substr(0, i % 17) + std::to_string(i));
+    for (size_t i = 0; i < 1500; ++i) {
+        std::string choice = choices[i % choices.size()] + "abcde";
+        short_choices.push_back(choice.substr(i % 5, 10) + std::to_string(i % 7));
+        long_choices.push_back(std::string(i % 100, 'a') + choices[i % choices.size()]);
+    }
+
+    for (size_t workers : {size_t(1), size_t(4)}) {
+        INFO("workers: " << workers);
+        for (const auto& choices_ : {short_choices, long_choices}) {
+            cdist_test(process::cdist<rapidfuzz::CachedLevenshtein, process::ScoreKind::Distance>(
+                           queries, choices_, workers),
+                       queries, choices_, [](const auto& s1, const auto& s2) {
+                           return rapidfuzz::levenshtein_distance(s1, s2);
+                       });
+
+            cdist_test(process::cdist<rapidfuzz::CachedLevenshtein, process::ScoreKind::Distance>(
+                           queries, choices_, workers, 5),
+                       queries, choices_, [](const auto& s1, const auto& s2) {
+                           return rapidfuzz::levenshtein_distance(s1, s2, {1, 1, 1}, 5);
+                       });
+
+            cdist_test(process::cdist<rapidfuzz::CachedLevenshtein, process::ScoreKind::Similarity>(
+                           queries, choices_, workers, 2, rapidfuzz::LevenshteinWeightTable{1, 1, 2}),
+                       queries, choices_, [](const auto& s1, const auto& s2) {
+                           return rapidfuzz::levenshtein_similarity(s1, s2, {1, 1, 2}, 2);
+                       });
+
+            cdist_test(process::cdist<rapidfuzz::CachedIndel, process::ScoreKind::NormalizedSimilarity>(
+                           queries, choices_, workers, 0.5),
+                       queries, choices_, [](const auto& s1, const auto& s2) {
+                           return rapidfuzz::indel_normalized_similarity(s1, s2, 0.5);
+                       });
+
+            cdist_test(process::cdist<rapidfuzz::fuzz::CachedRatio>(queries, choices_, workers), queries,
+                       choices_,
+                       [](const auto& s1, const auto& s2) { return rapidfuzz::fuzz::ratio(s1, s2); });
+        }
+    }
+
+    REQUIRE(process::cdist<rapidfuzz::CachedIndel>(queries, std::vector<std::string>()).empty());
+}